@@ -0,0 +1,651 @@
+// AsyncRecordIO.h - Deep-queue asynchronous reader/writer for the .dat record files
+//
+// The record tools used to issue one blocking fread per record, so the device
+// only ever saw a queue depth of 1. This header keeps many large reads or
+// writes in flight at once:
+//   - On Linux it talks to io_uring directly through the raw syscalls
+//     (no liburing needed).
+//   - If io_uring is unavailable (old kernel, seccomp, non-Linux POSIX) a small
+//     thread pool issues pread/pwrite calls instead.
+//
+// Reads are delivered to the caller in file order, one block at a time, even
+// though they complete out of order. Blocks are sized as whole records so the
+// callback can treat them as an array of structs.
+//
+// Usage:
+//   forEachRecordBatch<Employee>("employee.dat", [](const Employee *batch, size_t n) {
+//       ...; return true; // false stops early
+//   });
+
+#ifndef ASYNC_RECORD_IO_H
+#define ASYNC_RECORD_IO_H
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ASYNC_IO_HAVE_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+const int ASYNC_IO_QUEUE_DEPTH = 32;
+const size_t ASYNC_IO_ALIGNMENT = 4096;
+
+// One completed request: the tag given at submit time and the byte count (or -errno)
+struct IoCompletion
+{
+    int tag;
+    long result;
+};
+
+// Minimal backend interface shared by io_uring and the thread-pool fallback
+class IoBackend
+{
+public:
+    virtual ~IoBackend() {}
+    virtual bool submitRead(int fd, void *buf, size_t length, off_t offset, int tag) = 0;
+    virtual bool submitWrite(int fd, const void *buf, size_t length, off_t offset, int tag) = 0;
+    // Blocks until at least one request finishes
+    virtual bool wait(IoCompletion &completion) = 0;
+    virtual const char *name() const = 0;
+};
+
+#ifdef ASYNC_IO_HAVE_URING
+class UringBackend : public IoBackend
+{
+    int ringFd = -1;
+    unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    io_uring_sqe *sqes = nullptr;
+    io_uring_cqe *cqes;
+    void *sqRing = MAP_FAILED, *cqRing = MAP_FAILED;
+    size_t sqRingSize = 0, cqRingSize = 0, sqesSize = 0;
+    unsigned pendingSubmit = 0;
+
+    bool push(int op, int fd, const void *buf, size_t length, off_t offset, int tag)
+    {
+        unsigned tail = *sqTail;
+        if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) > *sqMask)
+            return false; // ring full; callers never exceed the depth
+
+        unsigned index = tail & *sqMask;
+        io_uring_sqe *sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = (unsigned char)op;
+        sqe->fd = fd;
+        sqe->addr = (unsigned long)buf;
+        sqe->len = (unsigned)length;
+        sqe->off = (unsigned long long)offset;
+        sqe->user_data = (unsigned long long)tag;
+        sqArray[index] = index;
+
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        pendingSubmit++;
+        return true;
+    }
+
+public:
+    explicit UringBackend(unsigned entries)
+    {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        ringFd = (int)syscall(__NR_io_uring_setup, entries, &params);
+        if (ringFd < 0)
+            return;
+
+        // IORING_OP_READ/WRITE arrived in 5.6; FAST_POLL (5.7) is the
+        // cheapest feature bit that guarantees them.
+        if (!(params.features & IORING_FEAT_FAST_POLL))
+        {
+            close(ringFd);
+            ringFd = -1;
+            return;
+        }
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single)
+            sqRingSize = cqRingSize = sqRingSize > cqRingSize ? sqRingSize : cqRingSize;
+
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        cqRing = single ? sqRing
+                        : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void *sqeMap = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+        if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqeMap == MAP_FAILED)
+        {
+            if (sqeMap != MAP_FAILED)
+                munmap(sqeMap, sqesSize);
+            close(ringFd);
+            ringFd = -1;
+            return;
+        }
+        sqes = (io_uring_sqe *)sqeMap;
+
+        char *sq = (char *)sqRing;
+        char *cq = (char *)cqRing;
+        sqHead = (unsigned *)(sq + params.sq_off.head);
+        sqTail = (unsigned *)(sq + params.sq_off.tail);
+        sqMask = (unsigned *)(sq + params.sq_off.ring_mask);
+        sqArray = (unsigned *)(sq + params.sq_off.array);
+        cqHead = (unsigned *)(cq + params.cq_off.head);
+        cqTail = (unsigned *)(cq + params.cq_off.tail);
+        cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+        cqes = (io_uring_cqe *)(cq + params.cq_off.cqes);
+    }
+
+    ~UringBackend() override
+    {
+        if (ringFd < 0)
+            return;
+        munmap(sqes, sqesSize);
+        if (cqRing != sqRing)
+            munmap(cqRing, cqRingSize);
+        munmap(sqRing, sqRingSize);
+        close(ringFd);
+    }
+
+    bool ok() const { return ringFd >= 0; }
+
+    bool submitRead(int fd, void *buf, size_t length, off_t offset, int tag) override
+    {
+        return push(IORING_OP_READ, fd, buf, length, offset, tag);
+    }
+
+    bool submitWrite(int fd, const void *buf, size_t length, off_t offset, int tag) override
+    {
+        return push(IORING_OP_WRITE, fd, buf, length, offset, tag);
+    }
+
+    bool enter(unsigned toSubmit, unsigned minComplete, unsigned flags)
+    {
+        while (true)
+        {
+            int ret = (int)syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0);
+            if (ret >= 0)
+            {
+                pendingSubmit -= (unsigned)ret < pendingSubmit ? (unsigned)ret : pendingSubmit;
+                return true;
+            }
+            if (errno != EINTR)
+                return false;
+        }
+    }
+
+    bool wait(IoCompletion &completion) override
+    {
+        // Hand new requests to the kernel first so the queue stays deep
+        if (pendingSubmit > 0 && !enter(pendingSubmit, 0, 0))
+            return false;
+
+        while (true)
+        {
+            unsigned head = *cqHead;
+            if (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+            {
+                io_uring_cqe *cqe = &cqes[head & *cqMask];
+                completion.tag = (int)cqe->user_data;
+                completion.result = cqe->res;
+                __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+
+            // Sleep until at least one request completes
+            if (!enter(pendingSubmit, 1, IORING_ENTER_GETEVENTS))
+                return false;
+        }
+    }
+
+    const char *name() const override { return "io_uring"; }
+};
+#endif
+
+// Fallback: worker threads run blocking pread/pwrite so several are in flight
+class ThreadPoolBackend : public IoBackend
+{
+    struct Request
+    {
+        bool isWrite;
+        int fd;
+        void *buf;
+        size_t length;
+        off_t offset;
+        int tag;
+    };
+
+    std::mutex mtx;
+    std::condition_variable requestReady, completionReady;
+    std::deque<Request> requests;
+    std::deque<IoCompletion> completions;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+
+    void run()
+    {
+        while (true)
+        {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                requestReady.wait(lock, [this]
+                                  { return stopping || !requests.empty(); });
+                if (requests.empty())
+                    return;
+                request = requests.front();
+                requests.pop_front();
+            }
+
+            ssize_t n = request.isWrite ? pwrite(request.fd, request.buf, request.length, request.offset)
+                                        : pread(request.fd, request.buf, request.length, request.offset);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                completions.push_back({request.tag, n < 0 ? -(long)errno : (long)n});
+            }
+            completionReady.notify_one();
+        }
+    }
+
+    bool push(const Request &request)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            requests.push_back(request);
+        }
+        requestReady.notify_one();
+        return true;
+    }
+
+public:
+    explicit ThreadPoolBackend(int threads)
+    {
+        for (int i = 0; i < threads; i++)
+            workers.emplace_back(&ThreadPoolBackend::run, this);
+    }
+
+    ~ThreadPoolBackend() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        requestReady.notify_all();
+        for (std::thread &t : workers)
+            t.join();
+    }
+
+    bool submitRead(int fd, void *buf, size_t length, off_t offset, int tag) override
+    {
+        return push({false, fd, buf, length, offset, tag});
+    }
+
+    bool submitWrite(int fd, const void *buf, size_t length, off_t offset, int tag) override
+    {
+        return push({true, fd, const_cast<void *>(buf), length, offset, tag});
+    }
+
+    bool wait(IoCompletion &completion) override
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        completionReady.wait(lock, [this]
+                             { return !completions.empty(); });
+        completion = completions.front();
+        completions.pop_front();
+        return true;
+    }
+
+    const char *name() const override { return "thread pool"; }
+};
+
+// Reaps inFlight outstanding requests so their buffers can be released.
+// io_uring_enter can fail transiently (EAGAIN, or EBUSY until completions are
+// reaped), so a failed wait is retried. False if they could not all be reaped:
+// the kernel may still be using the buffers, so the caller must not free them.
+inline bool drainBackend(IoBackend &backend, long inFlight)
+{
+    int failures = 0;
+    while (inFlight > 0)
+    {
+        IoCompletion completion;
+        if (backend.wait(completion))
+        {
+            inFlight--;
+            failures = 0;
+        }
+        else if (++failures == 1000)
+        {
+            return false;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    return true;
+}
+
+// Picks io_uring when the kernel allows it, otherwise the thread pool
+inline std::unique_ptr<IoBackend> makeIoBackend(int queueDepth)
+{
+#ifdef ASYNC_IO_HAVE_URING
+    if (getenv("ASYNC_IO_NO_URING") == nullptr)
+    {
+        std::unique_ptr<UringBackend> uring(new UringBackend((unsigned)queueDepth));
+        if (uring->ok())
+            return uring;
+    }
+#endif
+    int threads = queueDepth < 8 ? queueDepth : 8;
+    return std::unique_ptr<IoBackend>(new ThreadPoolBackend(threads));
+}
+
+// Page-aligned buffer so the same blocks could be used with O_DIRECT.
+// data is null if the allocation failed.
+struct AlignedBlock
+{
+    char *data = nullptr;
+    size_t capacity = 0;
+    size_t want = 0;   // bytes requested for this block
+    size_t filled = 0; // bytes transferred so far
+    off_t offset = 0;
+    bool done = false;
+
+    explicit AlignedBlock(size_t size) : capacity(size)
+    {
+        size_t rounded = (size + ASYNC_IO_ALIGNMENT - 1) / ASYNC_IO_ALIGNMENT * ASYNC_IO_ALIGNMENT;
+        data = (char *)aligned_alloc(ASYNC_IO_ALIGNMENT, rounded);
+    }
+    ~AlignedBlock() { free(data); }
+    AlignedBlock(const AlignedBlock &) = delete;
+    AlignedBlock &operator=(const AlignedBlock &) = delete;
+};
+
+// Reads a whole file in blockSize pieces with queueDepth reads in flight and
+// hands each block to onBlock(data, length) in file order. Returns false on an
+// I/O error; stops early (returning true) if onBlock returns false.
+template <typename Callback>
+bool readFileBlocks(const char *path, size_t blockSize, Callback onBlock, int queueDepth = ASYNC_IO_QUEUE_DEPTH)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    off_t fileSize = st.st_size;
+    long totalBlocks = (long)((fileSize + (off_t)blockSize - 1) / (off_t)blockSize);
+    int depth = totalBlocks < queueDepth ? (int)totalBlocks : queueDepth;
+    if (depth == 0)
+    {
+        close(fd);
+        return true;
+    }
+
+    std::vector<std::unique_ptr<AlignedBlock>> slots;
+    for (int i = 0; i < depth; i++)
+    {
+        slots.emplace_back(new AlignedBlock(blockSize));
+        if (slots.back()->data == nullptr)
+        {
+            close(fd);
+            return false;
+        }
+    }
+    std::unique_ptr<IoBackend> backend = makeIoBackend(depth);
+
+    long nextSubmit = 0, nextDeliver = 0, inFlight = 0;
+    bool ok = true, stop = false;
+
+    auto submitBlock = [&](int slot)
+    {
+        AlignedBlock &block = *slots[slot];
+        block.offset = (off_t)nextSubmit * (off_t)blockSize;
+        block.want = (size_t)(fileSize - block.offset < (off_t)blockSize ? fileSize - block.offset : (off_t)blockSize);
+        block.filled = 0;
+        block.done = false;
+        nextSubmit++;
+        if (!backend->submitRead(fd, block.data, block.want, block.offset, slot))
+            return false;
+        inFlight++;
+        return true;
+    };
+
+    for (int i = 0; i < depth && ok; i++)
+        ok = submitBlock(i);
+
+    while (inFlight > 0)
+    {
+        IoCompletion completion;
+        if (!backend->wait(completion))
+        {
+            // Reads may still land in the slots; if they cannot be reaped,
+            // leak the buffers rather than free memory the kernel writes to
+            if (!drainBackend(*backend, inFlight))
+            {
+                for (std::unique_ptr<AlignedBlock> &slot : slots)
+                    slot.release();
+            }
+            ok = false;
+            break;
+        }
+        inFlight--;
+
+        AlignedBlock &block = *slots[completion.tag];
+        if (completion.result <= 0)
+        {
+            ok = false; // error or unexpected EOF; drain what is still in flight
+            continue;
+        }
+
+        block.filled += (size_t)completion.result;
+        if (block.filled < block.want)
+        {
+            // Short read: ask for the rest of the block
+            if (backend->submitRead(fd, block.data + block.filled, block.want - block.filled,
+                                    block.offset + (off_t)block.filled, completion.tag))
+                inFlight++;
+            else
+                ok = false;
+            continue;
+        }
+        block.done = true;
+
+        // Deliver every block that is now contiguous with what was delivered
+        while (ok && !stop && nextDeliver < totalBlocks && slots[nextDeliver % depth]->done)
+        {
+            int slot = (int)(nextDeliver % depth);
+            if (!onBlock((const char *)slots[slot]->data, slots[slot]->filled))
+                stop = true;
+            nextDeliver++;
+            slots[slot]->done = false;
+            if (!stop && nextSubmit < totalBlocks)
+                ok = submitBlock(slot);
+        }
+    }
+
+    close(fd);
+    return ok;
+}
+
+// Record-typed wrapper: onBatch(const Record *records, size_t count)
+template <typename Record, typename Callback>
+bool forEachRecordBatch(const char *path, Callback onBatch, size_t recordsPerBatch = 8192)
+{
+    return readFileBlocks(path, recordsPerBatch * sizeof(Record), [&](const char *data, size_t length)
+                          { return onBatch((const Record *)data, length / sizeof(Record)); });
+}
+
+// Sequential writer that keeps several large pwrites in flight. append()
+// copies into the current block and submits it once full; close() drains.
+class AsyncFileWriter
+{
+    int fd = -1;
+    std::unique_ptr<IoBackend> backend;
+    std::vector<std::unique_ptr<AlignedBlock>> slots;
+    std::vector<int> freeSlots;
+    int current = -1;
+    off_t nextOffset = 0;
+    int inFlight = 0;
+    bool failed = false;
+
+    bool reapOne()
+    {
+        IoCompletion completion;
+        if (!backend->wait(completion))
+            return false;
+        inFlight--;
+
+        AlignedBlock &block = *slots[completion.tag];
+        if (completion.result <= 0)
+        {
+            failed = true;
+            freeSlots.push_back(completion.tag);
+            return true;
+        }
+        block.filled += (size_t)completion.result;
+        if (block.filled < block.want &&
+            backend->submitWrite(fd, block.data + block.filled, block.want - block.filled,
+                                 block.offset + (off_t)block.filled, completion.tag))
+        {
+            inFlight++;
+        }
+        else
+        {
+            if (block.filled < block.want)
+                failed = true;
+            freeSlots.push_back(completion.tag);
+        }
+        return true;
+    }
+
+    void submitCurrent()
+    {
+        AlignedBlock &block = *slots[current];
+        block.offset = nextOffset;
+        block.filled = 0;
+        nextOffset += (off_t)block.want;
+        if (backend->submitWrite(fd, block.data, block.want, block.offset, current))
+        {
+            inFlight++;
+        }
+        else
+        {
+            failed = true;
+            freeSlots.push_back(current);
+        }
+        current = -1;
+    }
+
+    bool takeSlot()
+    {
+        while (freeSlots.empty())
+        {
+            if (!reapOne())
+                return false;
+        }
+        current = freeSlots.back();
+        freeSlots.pop_back();
+        slots[current]->want = 0;
+        return true;
+    }
+
+public:
+    AsyncFileWriter() {}
+    AsyncFileWriter(const AsyncFileWriter &) = delete;
+    AsyncFileWriter &operator=(const AsyncFileWriter &) = delete;
+    ~AsyncFileWriter() { close(); }
+
+    bool open(const char *path, size_t blockSize = 1 << 20, int queueDepth = ASYNC_IO_QUEUE_DEPTH)
+    {
+        fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return false;
+        for (int i = 0; i < queueDepth; i++)
+        {
+            slots.emplace_back(new AlignedBlock(blockSize));
+            if (slots.back()->data == nullptr)
+            {
+                slots.clear();
+                freeSlots.clear();
+                ::close(fd);
+                fd = -1;
+                return false;
+            }
+            freeSlots.push_back(i);
+        }
+        backend = makeIoBackend(queueDepth);
+        return true;
+    }
+
+    bool isOpen() const { return fd >= 0; }
+
+    bool append(const void *data, size_t length)
+    {
+        const char *p = (const char *)data;
+        while (length > 0 && !failed)
+        {
+            if (current < 0 && !takeSlot())
+                return false;
+            AlignedBlock &block = *slots[current];
+            size_t room = block.capacity - block.want;
+            size_t n = length < room ? length : room;
+            memcpy(block.data + block.want, p, n);
+            block.want += n;
+            p += n;
+            length -= n;
+            if (block.want == block.capacity)
+                submitCurrent();
+        }
+        return !failed;
+    }
+
+    // Flushes the partial block, waits for every write and closes the file
+    bool close()
+    {
+        if (fd < 0)
+            return !failed;
+        if (current >= 0 && slots[current]->want > 0)
+            submitCurrent();
+        while (inFlight > 0)
+        {
+            if (!reapOne())
+            {
+                // Writes may still be reading from the slots; keep the
+                // buffers alive if they cannot be reaped
+                if (!drainBackend(*backend, inFlight))
+                {
+                    for (std::unique_ptr<AlignedBlock> &slot : slots)
+                        slot.release();
+                }
+                inFlight = 0;
+                failed = true;
+                break;
+            }
+        }
+        ::close(fd);
+        fd = -1;
+        return !failed;
+    }
+
+    const char *backendName() const { return backend ? backend->name() : "none"; }
+};
+
+#endif // ASYNC_RECORD_IO_H
@@ -2,6 +2,15 @@
 #include <iostream>
 #include <cstdio>
 #include <cstring>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AsyncRecordIO.h"
 using namespace std;
 
 struct Employee
@@ -11,6 +20,47 @@ struct Employee
     float basicSalary;
 };
 
+// Batch pipeline tuning: records read per fread, the worst-case size of one
+// formatted slip (fixed text + 100-char name + numbers fits well under this),
+// and how many chunks may be in the pipeline at once. The last one bounds
+// memory (about 8 MB of slip text per full chunk) whatever the core count.
+const int CHUNK_RECORDS = 8192;
+const int SLIP_BUFFER_SIZE = 1024;
+const int MAX_CHUNKS_IN_FLIGHT = 8;
+
+// Index entry written to payroll_slips.idx, one per slip in the archive
+struct SlipIndexEntry
+{
+    int empId;
+    int length;
+    long long offset;
+};
+
+// Formats one salary slip into buf and returns the number of bytes written
+int formatSlip(const Employee &emp, char *buf, int capacity)
+{
+    float DA = emp.basicSalary * 0.2f;
+    float HRA = emp.basicSalary * 0.1f;
+    float netSalary = emp.basicSalary + DA + HRA;
+
+    int len = snprintf(buf, capacity,
+                       "=========================================\n"
+                       "       EMPLOYEE SALARY SLIP\n"
+                       "=========================================\n\n"
+                       "Employee ID   : %d\n"
+                       "Employee Name : %s\n"
+                       "-----------------------------------------\n"
+                       "Basic Salary            : Rs. %.2f\n"
+                       "Dearness Allowance (DA) : Rs. %.2f\n"
+                       "House Rent Allowance (HRA): Rs. %.2f\n"
+                       "-----------------------------------------\n"
+                       "Net Salary              : Rs. %.2f\n"
+                       "=========================================\n",
+                       emp.empId, emp.name, emp.basicSalary, DA, HRA, netSalary);
+
+    return len < capacity ? len : capacity - 1;
+}
+
 void createEmployeeData()
 {
     FILE *file = fopen("employee.dat", "wb");
@@ -68,10 +118,6 @@ void processEmployeeRecords()
 
     while (fread(&emp, sizeof(Employee), 1, file) == 1)
     {
-        float DA = emp.basicSalary * 0.2f;
-        float HRA = emp.basicSalary * 0.1f;
-        float netSalary = emp.basicSalary + DA + HRA;
-
         char fileName[50];
         sprintf(fileName, "emp%d_slip.txt", emp.empId);
 
@@ -82,18 +128,9 @@ void processEmployeeRecords()
             continue;
         }
 
-        fprintf(slipFile, "=========================================\n");
-        fprintf(slipFile, "       EMPLOYEE SALARY SLIP\n");
-        fprintf(slipFile, "=========================================\n\n");
-        fprintf(slipFile, "Employee ID   : %d\n", emp.empId);
-        fprintf(slipFile, "Employee Name : %s\n", emp.name);
-        fprintf(slipFile, "-----------------------------------------\n");
-        fprintf(slipFile, "Basic Salary            : Rs. %.2f\n", emp.basicSalary);
-        fprintf(slipFile, "Dearness Allowance (DA) : Rs. %.2f\n", DA);
-        fprintf(slipFile, "House Rent Allowance (HRA): Rs. %.2f\n", HRA);
-        fprintf(slipFile, "-----------------------------------------\n");
-        fprintf(slipFile, "Net Salary              : Rs. %.2f\n", netSalary);
-        fprintf(slipFile, "=========================================\n");
+        char slip[SLIP_BUFFER_SIZE];
+        int slipLength = formatSlip(emp, slip, SLIP_BUFFER_SIZE);
+        fwrite(slip, 1, slipLength, slipFile);
 
         fclose(slipFile);
 
@@ -113,40 +150,335 @@ void processEmployeeRecords()
     }
 }
 
-void displayEmployeeRecords()
+// One unit of work in the batch pipeline. Chunks are created only as the
+// reader needs them and then recycled; buffers grow to the records actually
+// read, so a small file never pays for a full chunk and the steady state does
+// no per-record allocation.
+struct SlipChunk
 {
-    FILE *file = fopen("employee.dat", "rb");
+    long sequence = 0;
+    int count = 0;
+    vector<Employee> records;
+    vector<char> text;
+    vector<int> lengths;
+
+    void fill(const Employee *batch, size_t n)
+    {
+        records.assign(batch, batch + n);
+        if (text.size() < n * SLIP_BUFFER_SIZE)
+            text.resize(n * SLIP_BUFFER_SIZE);
+        if (lengths.size() < n)
+            lengths.resize(n);
+        count = (int)n;
+    }
+};
+
+// Small blocking queue used to hand chunks between pipeline stages
+class ChunkQueue
+{
+    deque<SlipChunk *> items;
+    mutex mtx;
+    condition_variable cv;
+    bool closed = false;
+
+public:
+    void push(SlipChunk *chunk)
+    {
+        {
+            lock_guard<mutex> lock(mtx);
+            items.push_back(chunk);
+        }
+        cv.notify_one();
+    }
+
+    // Returns nullptr if nothing is queued right now
+    SlipChunk *tryPop()
+    {
+        lock_guard<mutex> lock(mtx);
+        if (items.empty())
+            return nullptr;
+        SlipChunk *chunk = items.front();
+        items.pop_front();
+        return chunk;
+    }
+
+    // Returns nullptr once the queue is closed and drained
+    SlipChunk *pop()
+    {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this] { return !items.empty() || closed; });
+        if (items.empty())
+            return nullptr;
+        SlipChunk *chunk = items.front();
+        items.pop_front();
+        return chunk;
+    }
+
+    void close()
+    {
+        {
+            lock_guard<mutex> lock(mtx);
+            closed = true;
+        }
+        cv.notify_all();
+    }
+};
+
+// Batch pipeline: the calling thread reads employee.dat in CHUNK_RECORDS-sized
+// blocks through the async reader, a pool of workers formats slips into each
+// chunk's preallocated text buffer, and output goes either to one file per
+// employee (written by the workers) or to a single archive + index written in
+// order by a writer thread.
+void processEmployeeRecordsBatched(bool singleArchive)
+{
+    if (access("employee.dat", R_OK) != 0)
+    {
+        cout << "Error: Could not open employee.dat file!" << endl;
+        cout << "Please create the file first using option 1." << endl;
+        return;
+    }
+
+    AsyncFileWriter archive;
+    FILE *indexFile = NULL;
+    if (singleArchive)
+    {
+        indexFile = fopen("payroll_slips.idx", "wb");
+        if (!archive.open("payroll_slips.txt") || indexFile == NULL)
+        {
+            cout << "Error: Could not create payroll_slips archive!" << endl;
+            if (indexFile)
+                fclose(indexFile);
+            return;
+        }
+    }
+
+    // More workers than chunks in flight would only sit idle
+    int numWorkers = (int)thread::hardware_concurrency();
+    if (numWorkers <= 0)
+        numWorkers = 2;
+    numWorkers = min(numWorkers, MAX_CHUNKS_IN_FLIGHT);
+
+    // Two chunks per worker keeps everyone busy while the reader refills; the
+    // reader only creates one when none is free, so small files use fewer
+    int maxChunks = min(numWorkers * 2, MAX_CHUNKS_IN_FLIGHT);
+    vector<unique_ptr<SlipChunk>> pool;
+    ChunkQueue freeChunks, workQueue, doneQueue;
+
+    mutex countMtx;
+    long generated = 0;
+    long failed = 0;
+
+    auto start = chrono::steady_clock::now();
+
+    vector<thread> workers;
+    for (int w = 0; w < numWorkers; w++)
+    {
+        workers.emplace_back([&]()
+                             {
+            char fileName[50];
+            while (SlipChunk *chunk = workQueue.pop())
+            {
+                int ok = 0;
+                for (int i = 0; i < chunk->count; i++)
+                {
+                    char *slip = &chunk->text[(size_t)i * SLIP_BUFFER_SIZE];
+                    chunk->lengths[i] = formatSlip(chunk->records[i], slip, SLIP_BUFFER_SIZE);
+
+                    if (singleArchive)
+                        continue;
+
+                    snprintf(fileName, sizeof(fileName), "emp%d_slip.txt", chunk->records[i].empId);
+                    FILE *slipFile = fopen(fileName, "w");
+                    if (slipFile == NULL)
+                        continue;
+                    fwrite(slip, 1, chunk->lengths[i], slipFile);
+                    fclose(slipFile);
+                    ok++;
+                }
+
+                if (singleArchive)
+                {
+                    doneQueue.push(chunk);
+                }
+                else
+                {
+                    {
+                        lock_guard<mutex> lock(countMtx);
+                        generated += ok;
+                        failed += chunk->count - ok;
+                    }
+                    freeChunks.push(chunk);
+                }
+            } });
+    }
+
+    // Archive writer: chunks finish out of order, so park them until their
+    // sequence number comes up and then append slips and index entries.
+    thread writer;
+    if (singleArchive)
+    {
+        writer = thread([&]()
+                        {
+            map<long, SlipChunk *> parked;
+            long nextSequence = 0;
+            long long offset = 0;
+            vector<SlipIndexEntry> index;
+            index.reserve(CHUNK_RECORDS);
+
+            while (SlipChunk *chunk = doneQueue.pop())
+            {
+                parked[chunk->sequence] = chunk;
+                while (!parked.empty() && parked.begin()->first == nextSequence)
+                {
+                    SlipChunk *ready = parked.begin()->second;
+                    parked.erase(parked.begin());
+
+                    index.clear();
+                    for (int i = 0; i < ready->count; i++)
+                    {
+                        archive.append(&ready->text[(size_t)i * SLIP_BUFFER_SIZE], ready->lengths[i]);
+                        index.push_back({ready->records[i].empId, ready->lengths[i], offset});
+                        offset += ready->lengths[i];
+                    }
+                    fwrite(index.data(), sizeof(SlipIndexEntry), index.size(), indexFile);
+                    generated += ready->count;
+
+                    nextSequence++;
+                    freeChunks.push(ready);
+                }
+            } });
+    }
+
+    // Reader stage runs on the calling thread, with many block reads in flight
+    long sequence = 0;
+    bool readOk = forEachRecordBatch<Employee>("employee.dat", [&](const Employee *batch, size_t n)
+                                               {
+        SlipChunk *chunk = freeChunks.tryPop();
+        if (chunk == nullptr)
+        {
+            if ((int)pool.size() < maxChunks)
+            {
+                pool.emplace_back(new SlipChunk());
+                chunk = pool.back().get();
+            }
+            else
+            {
+                chunk = freeChunks.pop();
+            }
+        }
+        chunk->fill(batch, n);
+        chunk->sequence = sequence++;
+        workQueue.push(chunk);
+        return true; }, CHUNK_RECORDS);
+
+    workQueue.close();
+    for (thread &t : workers)
+        t.join();
+
+    if (singleArchive)
+    {
+        doneQueue.close();
+        writer.join();
+        if (!archive.close())
+            cout << "Error: Writing payroll_slips.txt failed!" << endl;
+        fclose(indexFile);
+    }
+
+    if (!readOk)
+        cout << "Error: Reading employee.dat failed part-way through!" << endl;
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "======================================" << endl;
+    cout << "Total salary slips generated: " << generated;
+    if (singleArchive)
+        cout << " -> payroll_slips.txt (index: payroll_slips.idx)";
+    cout << endl;
+    if (failed > 0)
+        cout << "Slips that could not be written: " << failed << endl;
+    printf("Workers: %d, time: %.3f s\n", numWorkers, seconds);
+
+    if (generated == 0)
+    {
+        cout << "No employee records found in the file." << endl;
+    }
+}
+
+// Writes count synthetic employees to employee.dat for trying the batch pipeline
+void generateSampleEmployees()
+{
+    long count;
+    cout << "Enter number of sample employees: ";
+    if (!(cin >> count) || count <= 0)
+    {
+        cout << "Error: Count must be positive." << endl;
+        cin.clear();
+        cin.ignore(10000, '\n');
+        return;
+    }
+
+    FILE *file = fopen("employee.dat", "wb");
     if (file == NULL)
+    {
+        cout << "Error: Could not create employee.dat file!" << endl;
+        return;
+    }
+
+    vector<Employee> chunk(CHUNK_RECORDS);
+    long written = 0;
+    while (written < count)
+    {
+        int n = (int)min<long>(CHUNK_RECORDS, count - written);
+        for (int i = 0; i < n; i++)
+        {
+            Employee &emp = chunk[i];
+            memset(&emp, 0, sizeof(Employee));
+            emp.empId = (int)(written + i + 1);
+            snprintf(emp.name, sizeof(emp.name), "Employee %d", emp.empId);
+            emp.basicSalary = 20000.0f + (float)(emp.empId % 500) * 100.0f;
+        }
+        fwrite(chunk.data(), sizeof(Employee), n, file);
+        written += n;
+    }
+
+    fclose(file);
+    cout << written << " sample employee records written to employee.dat" << endl;
+}
+
+void displayEmployeeRecords()
+{
+    if (access("employee.dat", R_OK) != 0)
     {
         cout << "Error: Could not open employee.dat file!" << endl;
         return;
     }
 
-    Employee emp;
     int count = 0;
 
     cout << "\n========================================" << endl;
     cout << "        EMPLOYEE RECORDS" << endl;
     cout << "========================================" << endl;
 
-    while (fread(&emp, sizeof(Employee), 1, file) == 1)
-    {
-        count++;
-        float DA = emp.basicSalary * 0.2f;
-        float HRA = emp.basicSalary * 0.1f;
-        float netSalary = emp.basicSalary + DA + HRA;
-
-        cout << "\nEmployee " << count << ":" << endl;
-        cout << "  ID            : " << emp.empId << endl;
-        cout << "  Name          : " << emp.name << endl;
-        printf("  Basic Salary  : Rs. %.2f\n", emp.basicSalary);
-        printf("  DA (20%%)      : Rs. %.2f\n", DA);
-        printf("  HRA (10%%)     : Rs. %.2f\n", HRA);
-        printf("  Net Salary    : Rs. %.2f\n", netSalary);
-        cout << "----------------------------------------" << endl;
-    }
+    forEachRecordBatch<Employee>("employee.dat", [&](const Employee *batch, size_t n)
+                                 {
+        for (size_t i = 0; i < n; i++)
+        {
+            const Employee &emp = batch[i];
+            count++;
+            float DA = emp.basicSalary * 0.2f;
+            float HRA = emp.basicSalary * 0.1f;
+            float netSalary = emp.basicSalary + DA + HRA;
 
-    fclose(file);
+            cout << "\nEmployee " << count << ":" << endl;
+            cout << "  ID            : " << emp.empId << endl;
+            cout << "  Name          : " << emp.name << endl;
+            printf("  Basic Salary  : Rs. %.2f\n", emp.basicSalary);
+            printf("  DA (20%%)      : Rs. %.2f\n", DA);
+            printf("  HRA (10%%)     : Rs. %.2f\n", HRA);
+            printf("  Net Salary    : Rs. %.2f\n", netSalary);
+            cout << "----------------------------------------" << endl;
+        }
+        return true; });
 
     if (count == 0)
     {
@@ -167,7 +499,9 @@ int main()
 
     while (true)
     {
-        cout << "\n1. Create Employee Data\n2. Generate Slips\n3. Display Records\n4. Exit\nChoice: ";
+        cout << "\n1. Create Employee Data\n2. Generate Slips\n3. Display Records\n"
+             << "4. Generate Slips (Batch, Individual Files)\n5. Generate Slips (Batch, Single Archive)\n"
+             << "6. Generate Sample Data\n7. Exit\nChoice: ";
         cin >> choice;
 
         switch (choice)
@@ -182,6 +516,15 @@ int main()
             displayEmployeeRecords();
             break;
         case 4:
+            processEmployeeRecordsBatched(false);
+            break;
+        case 5:
+            processEmployeeRecordsBatched(true);
+            break;
+        case 6:
+            generateSampleEmployees();
+            break;
+        case 7:
             return 0;
         default:
             cout << "Invalid choice\n";
@@ -2,6 +2,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 
 struct Student
 {
@@ -10,10 +16,356 @@ struct Student
     float marks;
 };
 
+/*
+ * Write-ahead log for appends.
+ *
+ * New records are first appended to students.wal and made durable with
+ * fdatasync; students.dat is only updated by a checkpoint. Concurrent callers
+ * of walAppend are grouped: whichever thread finds no commit in progress
+ * becomes the leader, writes every pending entry with one pwrite, issues one
+ * fdatasync and wakes the rest of the group.
+ *
+ * The WAL header stores how many records students.dat held when the log was
+ * started, so replay truncates the data file back to that size before
+ * re-applying entries. That makes a checkpoint that crashed half-way safe to
+ * run again. Only a log that still holds entries is replayed: an empty log's
+ * baseRecords may be stale (other programs rewrite students.dat), so it is
+ * never used to truncate. A clean walClose() deletes the log.
+ */
+#define DATA_FILE "students.dat"
+#define WAL_FILE "students.wal"
+#define WAL_MAGIC 0x4C415753u /* "SWAL" */
+#define WAL_VERSION 1
+#define WAL_BATCH_MAX 65536
+
+struct WalHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    int64_t baseRecords;
+};
+
+struct WalEntry
+{
+    uint64_t seq;
+    struct Student student;
+    uint32_t checksum;
+};
+
+struct WriteAheadLog
+{
+    int fd;
+    int64_t offset; /* where the next group is written */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct WalEntry *pending;  /* filled by appenders */
+    struct WalEntry *flushing; /* owned by the leader during a commit */
+    int pendingCount;
+    uint64_t nextSeq;
+    uint64_t durableSeq;
+    int leaderActive;
+    int failed;
+    uint64_t commits;
+};
+
+static struct WriteAheadLog wal = {-1, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, NULL, 0, 0, 0, 0, 0, 0};
+
+static uint32_t crcTable[256];
+
+static void initCrcTable(void)
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crcTable[i] = c;
+    }
+}
+
+static uint32_t crc32(const void *data, size_t length)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++)
+        c = crcTable[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+/* Checksum covers the sequence number and the record, not the checksum field */
+static uint32_t walEntryChecksum(const struct WalEntry *entry)
+{
+    return crc32(entry, offsetof(struct WalEntry, checksum));
+}
+
+static int writeAll(int fd, const void *buf, size_t length, int64_t offset)
+{
+    const char *p = (const char *)buf;
+    while (length > 0)
+    {
+        ssize_t n = pwrite(fd, p, length, offset);
+        if (n < 0)
+            return -1;
+        p += n;
+        offset += n;
+        length -= (size_t)n;
+    }
+    return 0;
+}
+
+/* Starts an empty log whose base is the current size of students.dat */
+static int walReset(int64_t baseRecords)
+{
+    struct WalHeader header = {WAL_MAGIC, WAL_VERSION, baseRecords};
+
+    if (ftruncate(wal.fd, 0) != 0 ||
+        writeAll(wal.fd, &header, sizeof(header), 0) != 0 ||
+        fdatasync(wal.fd) != 0)
+        return -1;
+
+    wal.offset = sizeof(header);
+    return 0;
+}
+
+/*
+ * Copies every valid WAL entry into students.dat and starts a fresh log.
+ * Replay stops at the first entry with a bad checksum or sequence gap,
+ * which is where a crash tore the last group commit. Without any valid
+ * entry students.dat is left exactly as it is.
+ * Caller must ensure no commit is in flight.
+ */
+static int walApplyToDataFile(int *applied)
+{
+    struct WalHeader header;
+    *applied = 0;
+
+    int dataFd = open(DATA_FILE, O_RDWR | O_CREAT, 0644);
+    if (dataFd < 0)
+        return -1;
+
+    int64_t dataRecords = lseek(dataFd, 0, SEEK_END) / (int64_t)sizeof(struct Student);
+
+    if (pread(wal.fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+        header.magic == WAL_MAGIC && header.version == WAL_VERSION)
+    {
+        struct WalEntry *entries = (struct WalEntry *)malloc(sizeof(struct WalEntry) * WAL_BATCH_MAX);
+        struct Student *records = (struct Student *)malloc(sizeof(struct Student) * WAL_BATCH_MAX);
+        int64_t readOffset = sizeof(header);
+        int64_t writeRecord = header.baseRecords;
+        uint64_t expectedSeq = 0;
+        int torn = 0;
+
+        if (entries == NULL || records == NULL)
+        {
+            free(entries);
+            free(records);
+            close(dataFd);
+            return -1;
+        }
+
+        /* Look at the first batch before touching students.dat */
+        ssize_t n = pread(wal.fd, entries, sizeof(struct WalEntry) * WAL_BATCH_MAX, readOffset);
+        int count = n > 0 ? (int)(n / (ssize_t)sizeof(struct WalEntry)) : 0;
+        int hasEntries = count > 0 && entries[0].checksum == walEntryChecksum(&entries[0]);
+
+        /* A checkpoint only ever cuts students.dat back to baseRecords, so a
+           smaller file was replaced by someone else; replaying would corrupt it */
+        if (hasEntries && dataRecords < header.baseRecords)
+        {
+            printf("Error: %s has %lld records but %s expects at least %lld; not replaying\n",
+                   DATA_FILE, (long long)dataRecords, WAL_FILE, (long long)header.baseRecords);
+            free(entries);
+            free(records);
+            close(dataFd);
+            return -1;
+        }
+
+        if (hasEntries && ftruncate(dataFd, header.baseRecords * (int64_t)sizeof(struct Student)) != 0)
+        {
+            free(entries);
+            free(records);
+            close(dataFd);
+            return -1;
+        }
+
+        while (hasEntries && !torn && count > 0)
+        {
+            int valid = 0;
+            for (; valid < count; valid++)
+            {
+                const struct WalEntry *entry = &entries[valid];
+                if ((expectedSeq != 0 && entry->seq != expectedSeq) || entry->checksum != walEntryChecksum(entry))
+                {
+                    torn = 1;
+                    break;
+                }
+                expectedSeq = entry->seq + 1;
+                records[valid] = entry->student;
+            }
+
+            if (valid > 0 &&
+                writeAll(dataFd, records, sizeof(struct Student) * valid, writeRecord * (int64_t)sizeof(struct Student)) != 0)
+            {
+                free(entries);
+                free(records);
+                close(dataFd);
+                return -1;
+            }
+
+            writeRecord += valid;
+            *applied += valid;
+            readOffset += (int64_t)count * (int64_t)sizeof(struct WalEntry);
+
+            n = pread(wal.fd, entries, sizeof(struct WalEntry) * WAL_BATCH_MAX, readOffset);
+            count = n > 0 ? (int)(n / (ssize_t)sizeof(struct WalEntry)) : 0;
+        }
+
+        free(entries);
+        free(records);
+        if (hasEntries)
+            dataRecords = writeRecord;
+    }
+
+    /* Data must be durable before the log that could rebuild it is dropped */
+    if (fsync(dataFd) != 0)
+    {
+        close(dataFd);
+        return -1;
+    }
+    close(dataFd);
+
+    return walReset(dataRecords);
+}
+
+/* Opens the log and replays anything left over from a previous run */
+int walOpen(void)
+{
+    initCrcTable();
+
+    wal.fd = open(WAL_FILE, O_RDWR | O_CREAT, 0644);
+    wal.pending = (struct WalEntry *)malloc(sizeof(struct WalEntry) * WAL_BATCH_MAX);
+    wal.flushing = (struct WalEntry *)malloc(sizeof(struct WalEntry) * WAL_BATCH_MAX);
+    if (wal.fd < 0 || wal.pending == NULL || wal.flushing == NULL)
+    {
+        printf("Error: Could not open write-ahead log!\n");
+        return -1;
+    }
+
+    int recovered;
+    if (walApplyToDataFile(&recovered) != 0)
+    {
+        printf("Error: Write-ahead log recovery failed!\n");
+        return -1;
+    }
+
+    if (recovered > 0)
+    {
+        printf("Recovered %d record(s) from write-ahead log\n", recovered);
+    }
+
+    return 0;
+}
+
+/*
+ * Appends one record durably. Returns 0 once the record's group commit has
+ * reached disk, or -1 if the log is unusable.
+ */
+int walAppend(const struct Student *student)
+{
+    pthread_mutex_lock(&wal.lock);
+
+    /* Back-pressure while a full batch waits for the current commit */
+    while (wal.pendingCount == WAL_BATCH_MAX && !wal.failed)
+        pthread_cond_wait(&wal.cond, &wal.lock);
+
+    if (wal.failed)
+    {
+        pthread_mutex_unlock(&wal.lock);
+        return -1;
+    }
+
+    struct WalEntry *entry = &wal.pending[wal.pendingCount++];
+    memset(entry, 0, sizeof(*entry));
+    entry->seq = ++wal.nextSeq;
+    entry->student = *student;
+    entry->checksum = walEntryChecksum(entry);
+    uint64_t mySeq = entry->seq;
+
+    while (wal.durableSeq < mySeq && !wal.failed)
+    {
+        if (wal.leaderActive)
+        {
+            pthread_cond_wait(&wal.cond, &wal.lock);
+            continue;
+        }
+
+        /* Become the leader for everything pending right now */
+        struct WalEntry *batch = wal.pending;
+        int count = wal.pendingCount;
+        uint64_t lastSeq = wal.nextSeq;
+        int64_t offset = wal.offset;
+
+        wal.pending = wal.flushing;
+        wal.flushing = batch;
+        wal.pendingCount = 0;
+        wal.leaderActive = 1;
+        wal.offset += (int64_t)count * (int64_t)sizeof(struct WalEntry);
+        pthread_cond_broadcast(&wal.cond);
+        pthread_mutex_unlock(&wal.lock);
+
+        int ok = writeAll(wal.fd, batch, sizeof(struct WalEntry) * count, offset) == 0 &&
+                 fdatasync(wal.fd) == 0;
+
+        pthread_mutex_lock(&wal.lock);
+        if (ok)
+            wal.durableSeq = lastSeq;
+        else
+            wal.failed = 1;
+        wal.commits++;
+        wal.leaderActive = 0;
+        pthread_cond_broadcast(&wal.cond);
+    }
+
+    int result = wal.durableSeq >= mySeq ? 0 : -1;
+    pthread_mutex_unlock(&wal.lock);
+    return result;
+}
+
+/* Folds the log into students.dat. Call when no appends are running. */
+int walCheckpoint(void)
+{
+    int applied;
+
+    pthread_mutex_lock(&wal.lock);
+    while (wal.leaderActive)
+        pthread_cond_wait(&wal.cond, &wal.lock);
+    int result = wal.failed ? -1 : walApplyToDataFile(&applied);
+    pthread_mutex_unlock(&wal.lock);
+
+    return result;
+}
+
+/* Checkpoints and deletes the log, so no stale header outlives the run */
+void walClose(void)
+{
+    if (wal.fd >= 0)
+    {
+        int checkpointed = walCheckpoint() == 0;
+        if (!checkpointed)
+            printf("Warning: Checkpoint failed, records remain in %s\n", WAL_FILE);
+        close(wal.fd);
+        wal.fd = -1;
+        if (checkpointed)
+            unlink(WAL_FILE);
+    }
+    free(wal.pending);
+    free(wal.flushing);
+    wal.pending = wal.flushing = NULL;
+}
+
 void addStudentRecord()
 {
     struct Student student;
-    FILE *file;
 
     printf("\n=== Add Student Record ===\n");
 
@@ -73,22 +425,12 @@ void addStudentRecord()
         return;
     }
 
-    file = fopen("students.dat", "ab");
-    if (file == NULL)
+    if (walAppend(&student) != 0)
     {
-        printf("Error: Could not open file for writing!\n");
+        printf("Error: Failed to write record to the write-ahead log!\n");
         return;
     }
 
-    if (fwrite(&student, sizeof(struct Student), 1, file) != 1)
-    {
-        printf("Error: Failed to write record to file!\n");
-        fclose(file);
-        return;
-    }
-
-    fclose(file);
-
     printf("\nStudent record added successfully\n");
 }
 
@@ -100,6 +442,11 @@ void displayAllRecords()
 
     printf("\n=== All Student Records ===\n");
 
+    if (walCheckpoint() != 0)
+    {
+        printf("Warning: Could not checkpoint write-ahead log, recent records may be missing.\n");
+    }
+
     file = fopen("students.dat", "rb");
     if (file == NULL)
     {
@@ -131,10 +478,108 @@ void displayAllRecords()
     fclose(file);
 }
 
+struct IngestArgs
+{
+    int firstRollNo;
+    int count;
+    int errors;
+};
+
+static void *ingestWorker(void *arg)
+{
+    struct IngestArgs *args = (struct IngestArgs *)arg;
+    struct Student student;
+
+    for (int i = 0; i < args->count; i++)
+    {
+        memset(&student, 0, sizeof(student));
+        student.rollNo = args->firstRollNo + i;
+        snprintf(student.name, sizeof(student.name), "Student %d", student.rollNo);
+        student.marks = (float)(student.rollNo % 101);
+
+        if (walAppend(&student) != 0)
+            args->errors++;
+    }
+    return NULL;
+}
+
+/* Appends synthetic records from several threads to measure group commit */
+void bulkIngestBenchmark()
+{
+    int threads, perThread;
+
+    printf("\n=== Bulk Ingest (Write-Ahead Log) ===\n");
+    printf("Enter number of writer threads: ");
+    if (scanf("%d", &threads) != 1 || threads <= 0 || threads > 256)
+    {
+        printf("Error: Thread count must be between 1 and 256!\n");
+        while (getchar() != '\n')
+            ;
+        return;
+    }
+    printf("Enter records per thread: ");
+    if (scanf("%d", &perThread) != 1 || perThread <= 0)
+    {
+        printf("Error: Record count must be positive!\n");
+        while (getchar() != '\n')
+            ;
+        return;
+    }
+    while (getchar() != '\n')
+        ;
+
+    pthread_t *ids = (pthread_t *)malloc(sizeof(pthread_t) * threads);
+    struct IngestArgs *args = (struct IngestArgs *)malloc(sizeof(struct IngestArgs) * threads);
+    if (ids == NULL || args == NULL)
+    {
+        printf("Error: Out of memory!\n");
+        free(ids);
+        free(args);
+        return;
+    }
+
+    uint64_t commitsBefore = wal.commits;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int t = 0; t < threads; t++)
+    {
+        args[t].firstRollNo = 1 + t * perThread;
+        args[t].count = perThread;
+        args[t].errors = 0;
+        pthread_create(&ids[t], NULL, ingestWorker, &args[t]);
+    }
+
+    int errors = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        pthread_join(ids[t], NULL);
+        errors += args[t].errors;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    long total = (long)threads * perThread;
+    uint64_t commits = wal.commits - commitsBefore;
+
+    printf("\nRecords appended : %ld (%d failed)\n", total - errors, errors);
+    printf("Group commits    : %llu (avg %.1f records/commit)\n",
+           (unsigned long long)commits, commits ? (double)total / commits : 0.0);
+    printf("Elapsed          : %.3f s (%.0f records/s)\n", seconds, total / seconds);
+
+    free(ids);
+    free(args);
+
+    if (walCheckpoint() != 0)
+    {
+        printf("Warning: Checkpoint failed, records remain in %s\n", WAL_FILE);
+    }
+}
+
 void displayMenu()
 {
     printf("\nStudent Record Management\n");
-    printf("1. Add Student Record\n2. Display All Records\n3. Exit\nChoice: ");
+    printf("1. Add Student Record\n2. Display All Records\n3. Bulk Ingest Benchmark\n4. Exit\nChoice: ");
 }
 
 int main()
@@ -143,6 +588,11 @@ int main()
 
     printf("\nStudent Record Management System\n");
 
+    if (walOpen() != 0)
+    {
+        return 1;
+    }
+
     while (1)
     {
         displayMenu();
@@ -167,6 +617,10 @@ int main()
             displayAllRecords();
             break;
         case 3:
+            bulkIngestBenchmark();
+            break;
+        case 4:
+            walClose();
             printf("\nExiting...\n\n");
             exit(0);
         default:
@@ -2,6 +2,15 @@
 #include <iostream>
 #include <cstdio>
 #include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "AsyncRecordIO.h"
 using namespace std;
 
 struct Student
@@ -52,15 +61,13 @@ void createStudentRecords()
 
 void displayAllRecords()
 {
-    FILE *file = fopen("students.dat", "rb");
-    if (file == NULL)
+    if (access("students.dat", R_OK) != 0)
     {
         cout << "Error: Could not open 'students.dat' file!" << endl;
         cout << "Please create student records first." << endl;
         return;
     }
 
-    Student student;
     int count = 0;
 
     cout << "\n==========================================================" << endl;
@@ -69,13 +76,17 @@ void displayAllRecords()
     cout << "Roll No  | Name                      | Marks" << endl;
     cout << "---------+---------------------------+-------" << endl;
 
-    while (fread(&student, sizeof(Student), 1, file) == 1)
-    {
-        printf("%-8d | %-25s | %.2f\n", student.rollNo, student.name, student.marks);
-        count++;
-    }
+    bool readOk = forEachRecordBatch<Student>("students.dat", [&](const Student *batch, size_t n)
+                                              {
+        for (size_t i = 0; i < n; i++)
+        {
+            printf("%-8d | %-25s | %.2f\n", batch[i].rollNo, batch[i].name, batch[i].marks);
+        }
+        count += (int)n;
+        return true; });
 
-    fclose(file);
+    if (!readOk)
+        cout << "Error: Reading students.dat failed part-way through!" << endl;
 
     if (count == 0)
     {
@@ -118,16 +129,28 @@ void searchAndUpdateMarks()
     bool found = false;
     long position = 0;
 
-    // Search for the student record
-    while (fread(&student, sizeof(Student), 1, file) == 1)
-    {
-        if (student.rollNo == searchRollNo)
+    // Search for the student record; the async reader scans large files with
+    // many block reads in flight and stops at the first match
+    bool readOk = forEachRecordBatch<Student>("students.dat", [&](const Student *batch, size_t n)
+                                              {
+        for (size_t i = 0; i < n; i++, recordIndex++)
         {
-            found = true;
-            position = recordIndex * sizeof(Student);
-            break;
+            if (batch[i].rollNo == searchRollNo)
+            {
+                student = batch[i];
+                found = true;
+                position = recordIndex * sizeof(Student);
+                return false;
+            }
         }
-        recordIndex++;
+        return true; });
+
+    // A match is usable even if a read still in flight failed afterwards
+    if (!found && !readOk)
+    {
+        cout << "Error: Reading students.dat failed; the search could not be completed." << endl;
+        fclose(file);
+        return;
     }
 
     if (!found)
@@ -213,6 +236,356 @@ void searchAndUpdateMarks()
     fclose(file);
 }
 
+// ---------------------------------------------------------------------------
+// Columnar companion format
+//
+// students.dat stores 60-byte rows, so an aggregate over marks touches 15x more
+// memory than it needs. The converter below splits it into:
+//   students_roll.col   - int32 rollNo per row
+//   students_marks.col  - float marks per row
+//   students_name.col   - uint32 index into the name dictionary per row
+//   students_names.dict - uint32 count, then (uint8 length, bytes) per name
+// Every .col file starts with a uint32 row count.
+// ---------------------------------------------------------------------------
+
+const int HISTOGRAM_BUCKETS = 10; // 0-9, 10-19, ..., 90-100
+
+struct MarksSummary
+{
+    long count;
+    double sum;
+    float minMarks;
+    float maxMarks;
+};
+
+template <typename T>
+bool writeColumn(const char *fileName, const vector<T> &values)
+{
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL)
+        return false;
+
+    uint32_t rows = (uint32_t)values.size();
+    bool ok = fwrite(&rows, sizeof(rows), 1, file) == 1 &&
+              fwrite(values.data(), sizeof(T), values.size(), file) == values.size();
+    fclose(file);
+    return ok;
+}
+
+template <typename T>
+bool readColumn(const char *fileName, vector<T> &values)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL)
+        return false;
+
+    uint32_t rows = 0;
+    bool ok = fread(&rows, sizeof(rows), 1, file) == 1;
+    if (ok)
+    {
+        values.resize(rows);
+        ok = fread(values.data(), sizeof(T), rows, file) == rows;
+    }
+    fclose(file);
+    return ok;
+}
+
+// Reads the whole row file in one go; used by the converter and the row-scan baseline
+bool loadStudentRows(vector<Student> &rows)
+{
+    FILE *file = fopen("students.dat", "rb");
+    if (file == NULL)
+        return false;
+
+    fseek(file, 0, SEEK_END);
+    long bytes = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    rows.resize(bytes / sizeof(Student));
+    size_t got = fread(rows.data(), sizeof(Student), rows.size(), file);
+    rows.resize(got);
+    fclose(file);
+    return true;
+}
+
+void convertToColumnar()
+{
+    vector<Student> rows;
+    if (!loadStudentRows(rows))
+    {
+        cout << "Error: Could not open 'students.dat' file!" << endl;
+        return;
+    }
+
+    vector<int32_t> rollColumn(rows.size());
+    vector<float> marksColumn(rows.size());
+    vector<uint32_t> nameColumn(rows.size());
+    vector<string> dictionary;
+    unordered_map<string, uint32_t> nameIds;
+
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        rollColumn[i] = rows[i].rollNo;
+        marksColumn[i] = rows[i].marks;
+
+        string name(rows[i].name, strnlen(rows[i].name, sizeof(rows[i].name)));
+        auto it = nameIds.find(name);
+        if (it == nameIds.end())
+        {
+            it = nameIds.emplace(name, (uint32_t)dictionary.size()).first;
+            dictionary.push_back(name);
+        }
+        nameColumn[i] = it->second;
+    }
+
+    FILE *dictFile = fopen("students_names.dict", "wb");
+    if (dictFile == NULL)
+    {
+        cout << "Error: Could not create 'students_names.dict'!" << endl;
+        return;
+    }
+    uint32_t dictSize = (uint32_t)dictionary.size();
+    fwrite(&dictSize, sizeof(dictSize), 1, dictFile);
+    for (const string &name : dictionary)
+    {
+        // Names come from char[50], so the length always fits in one byte
+        uint8_t length = (uint8_t)name.size();
+        fwrite(&length, sizeof(length), 1, dictFile);
+        fwrite(name.data(), 1, length, dictFile);
+    }
+    fclose(dictFile);
+
+    if (!writeColumn("students_roll.col", rollColumn) ||
+        !writeColumn("students_marks.col", marksColumn) ||
+        !writeColumn("students_name.col", nameColumn))
+    {
+        cout << "Error: Could not write column files!" << endl;
+        return;
+    }
+
+    cout << "\nConverted " << rows.size() << " rows into column files ("
+         << dictionary.size() << " distinct names)." << endl;
+}
+
+// Sum / min / max over the marks column, four lanes at a time when SSE2 is available
+MarksSummary summarizeMarks(const float *marks, size_t n)
+{
+    MarksSummary summary = {(long)n, 0.0, 0.0f, 0.0f};
+    if (n == 0)
+        return summary;
+
+    size_t i = 0;
+    double sum = 0.0;
+    float minMarks = marks[0];
+    float maxMarks = marks[0];
+
+#ifdef __SSE2__
+    if (n >= 4)
+    {
+        __m128d sumLo = _mm_setzero_pd();
+        __m128d sumHi = _mm_setzero_pd();
+        __m128 minV = _mm_loadu_ps(marks);
+        __m128 maxV = minV;
+
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 v = _mm_loadu_ps(marks + i);
+            // Accumulate in double so millions of rows do not lose precision
+            sumLo = _mm_add_pd(sumLo, _mm_cvtps_pd(v));
+            sumHi = _mm_add_pd(sumHi, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+            minV = _mm_min_ps(minV, v);
+            maxV = _mm_max_ps(maxV, v);
+        }
+
+        double sums[4];
+        float mins[4], maxs[4];
+        _mm_storeu_pd(sums, sumLo);
+        _mm_storeu_pd(sums + 2, sumHi);
+        _mm_storeu_ps(mins, minV);
+        _mm_storeu_ps(maxs, maxV);
+        sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        for (int lane = 0; lane < 4; lane++)
+        {
+            minMarks = mins[lane] < minMarks ? mins[lane] : minMarks;
+            maxMarks = maxs[lane] > maxMarks ? maxs[lane] : maxMarks;
+        }
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        sum += marks[i];
+        minMarks = marks[i] < minMarks ? marks[i] : minMarks;
+        maxMarks = marks[i] > maxMarks ? marks[i] : maxMarks;
+    }
+
+    summary.sum = sum;
+    summary.minMarks = minMarks;
+    summary.maxMarks = maxMarks;
+    return summary;
+}
+
+long countAboveThreshold(const float *marks, size_t n, float threshold)
+{
+    size_t i = 0;
+    long count = 0;
+
+#ifdef __SSE2__
+    __m128 limit = _mm_set1_ps(threshold);
+    __m128i counts = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4)
+    {
+        // Comparison lanes are all-ones (-1) when true, so subtracting counts them
+        __m128 mask = _mm_cmpgt_ps(_mm_loadu_ps(marks + i), limit);
+        counts = _mm_sub_epi32(counts, _mm_castps_si128(mask));
+    }
+    int32_t lanes[4];
+    _mm_storeu_si128((__m128i *)lanes, counts);
+    count = (long)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+    for (; i < n; i++)
+    {
+        if (marks[i] > threshold)
+            count++;
+    }
+    return count;
+}
+
+// Ten-point buckets; 100 lands in the last bucket. Four private histograms
+// break the store-to-load dependency when neighbouring rows share a bucket.
+void marksHistogram(const float *marks, size_t n, long histogram[HISTOGRAM_BUCKETS])
+{
+    long partial[4][HISTOGRAM_BUCKETS] = {};
+    size_t i = 0;
+
+    auto bucketOf = [](float m)
+    {
+        int b = (int)(m * 0.1f);
+        return b < 0 ? 0 : (b >= HISTOGRAM_BUCKETS ? HISTOGRAM_BUCKETS - 1 : b);
+    };
+
+    for (; i + 4 <= n; i += 4)
+    {
+        partial[0][bucketOf(marks[i])]++;
+        partial[1][bucketOf(marks[i + 1])]++;
+        partial[2][bucketOf(marks[i + 2])]++;
+        partial[3][bucketOf(marks[i + 3])]++;
+    }
+    for (; i < n; i++)
+        partial[0][bucketOf(marks[i])]++;
+
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++)
+        histogram[b] = partial[0][b] + partial[1][b] + partial[2][b] + partial[3][b];
+}
+
+// Runs the aggregates on the marks column and, for comparison, the same
+// sum/min/max on the row file loaded into memory.
+void columnAggregates()
+{
+    vector<float> marks;
+    if (!readColumn("students_marks.col", marks))
+    {
+        cout << "Error: Could not read 'students_marks.col'. Convert the records first." << endl;
+        return;
+    }
+
+    float threshold;
+    cout << "\nCount students with marks above: ";
+    if (!(cin >> threshold))
+    {
+        cout << "Error: Invalid threshold!" << endl;
+        cin.clear();
+        cin.ignore(10000, '\n');
+        return;
+    }
+
+    auto start = chrono::steady_clock::now();
+    MarksSummary summary = summarizeMarks(marks.data(), marks.size());
+    long above = countAboveThreshold(marks.data(), marks.size(), threshold);
+    double columnMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    long histogram[HISTOGRAM_BUCKETS];
+    marksHistogram(marks.data(), marks.size(), histogram);
+    double histogramMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << "\n==========================================================" << endl;
+    cout << "                 MARKS AGGREGATES (COLUMNAR)" << endl;
+    cout << "==========================================================" << endl;
+    cout << "Students       : " << summary.count << endl;
+    if (summary.count > 0)
+    {
+        printf("Average        : %.2f\n", summary.sum / summary.count);
+        printf("Min / Max      : %.2f / %.2f\n", summary.minMarks, summary.maxMarks);
+    }
+    printf("Above %-8.2f : %ld\n", threshold, above);
+    cout << "Histogram:" << endl;
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++)
+    {
+        printf("  %3d-%-3d : %ld\n", b * 10, b == HISTOGRAM_BUCKETS - 1 ? 100 : b * 10 + 9, histogram[b]);
+    }
+
+    vector<Student> rows;
+    if (loadStudentRows(rows) && !rows.empty())
+    {
+        start = chrono::steady_clock::now();
+        double sum = 0.0;
+        float minMarks = rows[0].marks, maxMarks = rows[0].marks;
+        long rowAbove = 0;
+        for (const Student &row : rows)
+        {
+            sum += row.marks;
+            minMarks = row.marks < minMarks ? row.marks : minMarks;
+            maxMarks = row.marks > maxMarks ? row.marks : maxMarks;
+            if (row.marks > threshold)
+                rowAbove++;
+        }
+        double rowMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        // Printing the row results keeps the loop from being optimised away
+        printf("\nRow scan (sum/min/max/count)   : %.3f ms (avg %.2f, %ld above)\n",
+               rowMs, sum / rows.size(), rowAbove);
+        printf("Column scan (sum/min/max/count): %.3f ms\n", columnMs);
+        printf("Column histogram               : %.3f ms\n", histogramMs);
+    }
+    cout << "==========================================================" << endl;
+}
+
+// Writes count synthetic records so the column kernels have something to chew on
+void generateSampleStudents()
+{
+    long count;
+    cout << "\nEnter number of sample students: ";
+    if (!(cin >> count) || count <= 0)
+    {
+        cout << "Error: Count must be positive." << endl;
+        cin.clear();
+        cin.ignore(10000, '\n');
+        return;
+    }
+
+    FILE *file = fopen("students.dat", "wb");
+    if (file == NULL)
+    {
+        cout << "Error: Could not create students.dat file!" << endl;
+        return;
+    }
+
+    Student student;
+    for (long i = 0; i < count; i++)
+    {
+        memset(&student, 0, sizeof(Student));
+        student.rollNo = (int)(i + 1);
+        snprintf(student.name, sizeof(student.name), "Student %ld", i % 1000);
+        student.marks = (float)((i * 37) % 1001) / 10.0f;
+        fwrite(&student, sizeof(Student), 1, file);
+    }
+
+    fclose(file);
+    cout << count << " sample student records written to students.dat" << endl;
+}
+
 int main()
 {
     int choice;
@@ -227,7 +600,10 @@ int main()
         cout << "1. Create Student Records File" << endl;
         cout << "2. Display All Student Records" << endl;
         cout << "3. Search and Update Student Marks" << endl;
-        cout << "4. Exit" << endl;
+        cout << "4. Convert Records to Columnar Files" << endl;
+        cout << "5. Marks Aggregates (Columnar)" << endl;
+        cout << "6. Generate Sample Records" << endl;
+        cout << "7. Exit" << endl;
         cout << "Enter your choice: ";
         cin >> choice;
 
@@ -243,6 +619,15 @@ int main()
             searchAndUpdateMarks();
             break;
         case 4:
+            convertToColumnar();
+            break;
+        case 5:
+            columnAggregates();
+            break;
+        case 6:
+            generateSampleStudents();
+            break;
+        case 7:
             cout << "\nThank you for using the Student Marks Management System!" << endl;
             return 0;
         default:
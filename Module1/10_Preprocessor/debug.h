@@ -1,11 +1,168 @@
-#include <iostream>
-
 #ifndef DEBUG_H
 #define DEBUG_H
-#endif
 
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+// Original on/off switch. Writes '\n' instead of endl so each call no longer
+// forces a flush.
 #ifdef DEBUG
-#define DEBUG_PRINT(x) cout << x << endl;
+#define DEBUG_PRINT(x) (std::cout << x << '\n')
 #else
 #define DEBUG_PRINT(x)
 #endif
+
+// Leveled logging
+//
+// LOG_COMPILE_LEVEL picks the lowest level that is compiled in at all. Macros
+// below it expand to ((void)0), so their arguments are never evaluated and
+// no code is generated:
+//   g++ -DLOG_COMPILE_LEVEL=LOG_LEVEL_WARN app.cpp   // TRACE..INFO vanish
+// Defaults: everything with -DDEBUG, INFO and above otherwise.
+//
+// Levels that are compiled in can still be muted at run time with
+// setLogLevel(); that costs one relaxed atomic load per call.
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_WARN 3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_FATAL 5
+#define LOG_LEVEL_OFF 6
+
+#ifndef LOG_COMPILE_LEVEL
+#ifdef DEBUG
+#define LOG_COMPILE_LEVEL LOG_LEVEL_TRACE
+#else
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#endif
+#endif
+
+// Run-time threshold, shared by every translation unit
+inline std::atomic<int> &logRuntimeLevel()
+{
+    static std::atomic<int> level(LOG_COMPILE_LEVEL);
+    return level;
+}
+
+inline void setLogLevel(int level)
+{
+    logRuntimeLevel().store(level, std::memory_order_relaxed);
+}
+
+inline bool logLevelEnabled(int level)
+{
+    return level >= logRuntimeLevel().load(std::memory_order_relaxed);
+}
+
+// Lets at most maxPerSecond messages through per one-second window and counts
+// the rest, so a hot loop cannot flood the output. One instance per call site.
+class LogRateLimiter
+{
+    std::atomic<long long> windowStart;
+    std::atomic<int> used;
+    std::atomic<int> suppressed;
+    const int maxPerSecond;
+
+public:
+    explicit LogRateLimiter(int limit) : windowStart(0), used(0), suppressed(0), maxPerSecond(limit) {}
+
+    // Returns true if this message may be written; droppedBefore receives the
+    // number suppressed in the previous window (reported once)
+    bool allow(int &droppedBefore)
+    {
+        long long now = std::chrono::duration_cast<std::chrono::seconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count();
+        long long start = windowStart.load(std::memory_order_relaxed);
+        droppedBefore = 0;
+        if (now != start && windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed))
+        {
+            used.store(0, std::memory_order_relaxed);
+            droppedBefore = suppressed.exchange(0, std::memory_order_relaxed);
+        }
+        if (used.fetch_add(1, std::memory_order_relaxed) < maxPerSecond)
+            return true;
+        suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+};
+
+// clog is buffered stderr; ERROR and FATAL flush so they survive a crash
+#define LOG_IMPL(level, tag, x)                                                    \
+    do                                                                             \
+    {                                                                              \
+        if (logLevelEnabled(level))                                                \
+        {                                                                          \
+            std::clog << "[" tag "] " << __FILE__ << ":" << __LINE__ << ": " << x  \
+                      << '\n';                                                     \
+            if (level >= LOG_LEVEL_ERROR)                                          \
+                std::clog.flush();                                                 \
+        }                                                                          \
+    } while (0)
+
+#define LOG_RATE_LIMITED_IMPL(level, tag, maxPerSecond, x)                                 \
+    do                                                                                     \
+    {                                                                                      \
+        if (logLevelEnabled(level))                                                        \
+        {                                                                                  \
+            static LogRateLimiter logLimiter_(maxPerSecond);                               \
+            int logDropped_;                                                               \
+            bool logAllowed_ = logLimiter_.allow(logDropped_);                             \
+            if (logDropped_ > 0)                                                           \
+                std::clog << "[" tag "] " << __FILE__ << ":" << __LINE__ << ": ("          \
+                          << logDropped_ << " similar messages suppressed)\n";             \
+            if (logAllowed_)                                                               \
+                std::clog << "[" tag "] " << __FILE__ << ":" << __LINE__ << ": " << x      \
+                          << '\n';                                                         \
+        }                                                                                  \
+    } while (0)
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_TRACE
+#define LOG_TRACE(x) LOG_IMPL(LOG_LEVEL_TRACE, "TRACE", x)
+#define LOG_TRACE_LIMITED(n, x) LOG_RATE_LIMITED_IMPL(LOG_LEVEL_TRACE, "TRACE", n, x)
+#else
+#define LOG_TRACE(x) ((void)0)
+#define LOG_TRACE_LIMITED(n, x) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(x) LOG_IMPL(LOG_LEVEL_DEBUG, "DEBUG", x)
+#define LOG_DEBUG_LIMITED(n, x) LOG_RATE_LIMITED_IMPL(LOG_LEVEL_DEBUG, "DEBUG", n, x)
+#else
+#define LOG_DEBUG(x) ((void)0)
+#define LOG_DEBUG_LIMITED(n, x) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(x) LOG_IMPL(LOG_LEVEL_INFO, "INFO", x)
+#define LOG_INFO_LIMITED(n, x) LOG_RATE_LIMITED_IMPL(LOG_LEVEL_INFO, "INFO", n, x)
+#else
+#define LOG_INFO(x) ((void)0)
+#define LOG_INFO_LIMITED(n, x) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(x) LOG_IMPL(LOG_LEVEL_WARN, "WARN", x)
+#define LOG_WARN_LIMITED(n, x) LOG_RATE_LIMITED_IMPL(LOG_LEVEL_WARN, "WARN", n, x)
+#else
+#define LOG_WARN(x) ((void)0)
+#define LOG_WARN_LIMITED(n, x) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(x) LOG_IMPL(LOG_LEVEL_ERROR, "ERROR", x)
+#define LOG_ERROR_LIMITED(n, x) LOG_RATE_LIMITED_IMPL(LOG_LEVEL_ERROR, "ERROR", n, x)
+#else
+#define LOG_ERROR(x) ((void)0)
+#define LOG_ERROR_LIMITED(n, x) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_FATAL
+#define LOG_FATAL(x) LOG_IMPL(LOG_LEVEL_FATAL, "FATAL", x)
+#else
+#define LOG_FATAL(x) ((void)0)
+#endif
+
+#endif // DEBUG_H
@@ -30,8 +30,21 @@
 //
 //   CORRECT: Complete destruction chain - derived first, then base.
 //   All resources are properly cleaned up in the correct order.
+//
+// STATIC DISPATCH ALTERNATIVE:
+// Every log() call through a BaseLogger* is an indirect (virtual) call that the
+// compiler cannot inline. StaticLogger.h builds loggers with the same sinks from
+// compile-time policies instead, and AnyLogger wraps one when the choice has to
+// be made at run time. Run with --bench to compare the cost per message.
 
 #include <iostream>
+#include <cstdio>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "StaticLogger.h"
 
 // BaseLogger: Abstract base class for different logging mechanisms
 // Uses a VIRTUAL destructor to ensure proper cleanup in polymorphic hierarchies
@@ -41,11 +54,27 @@
 // call ~BaseLogger(), skipping ~FileLogger() entirely!
 class BaseLogger
 {
+protected:
+    LogLevel minimumLevel;
+    std::string buffer;
+
+    // Same "[LEVEL] message" layout as LevelPrefixFormat
+    std::string_view format(LogLevel level, std::string_view message)
+    {
+        return LevelPrefixFormat::format(level, message, buffer);
+    }
+
 public:
+    explicit BaseLogger(LogLevel minimum = LogLevel::Debug) : minimumLevel(minimum) {}
+
     virtual ~BaseLogger() // MUST be virtual for proper polymorphic behavior
     {
         std::cout << "  -> BaseLogger destructor called (base cleanup)" << std::endl;
     }
+
+    // Resolved at RUN-TIME: the call always goes through the vtable, even for
+    // messages that the filter below will throw away
+    virtual void log(LogLevel level, std::string_view message) = 0;
 };
 
 // FileLogger: Derived class that writes logs to files
@@ -56,11 +85,31 @@ public:
 // This would cause file handles to remain open and memory to leak.
 class FileLogger : public BaseLogger
 {
+    FILE *file;
+
 public:
+    explicit FileLogger(const char *fileName = "logger_demo.log", LogLevel minimum = LogLevel::Debug)
+        : BaseLogger(minimum), file(fopen(fileName, "a")) {}
+
     ~FileLogger()
     {
         std::cout << "  -> FileLogger destructor called (derived cleanup)" << std::endl;
-        // In a real implementation, this would close file handles, flush buffers, etc.
+        // Close the file handle; this is exactly what would leak without a virtual destructor
+        if (file != nullptr)
+        {
+            fclose(file);
+        }
+    }
+
+    void log(LogLevel level, std::string_view message) override
+    {
+        if (level < minimumLevel || file == nullptr)
+        {
+            return;
+        }
+        std::string_view text = format(level, message);
+        fwrite(text.data(), 1, text.size(), file);
+        fputc('\n', file);
     }
 };
 
@@ -72,14 +121,96 @@ public:
 class ConsoleLogger : public BaseLogger
 {
 public:
+    explicit ConsoleLogger(LogLevel minimum = LogLevel::Debug) : BaseLogger(minimum) {}
+
     ~ConsoleLogger()
     {
         std::cout << "  -> ConsoleLogger destructor called (derived cleanup)" << std::endl;
-        // In a real implementation, this would release console resources, flush output, etc.
+        // Flush anything still buffered for the console
+        fflush(stdout);
+    }
+
+    void log(LogLevel level, std::string_view message) override
+    {
+        if (level < minimumLevel)
+        {
+            return;
+        }
+        std::string_view text = format(level, message);
+        fwrite(text.data(), 1, text.size(), stdout);
+        fputc('\n', stdout);
+    }
+};
+
+// CountingLogger: does no I/O, so the benchmark measures dispatch and filtering
+class CountingLogger : public BaseLogger
+{
+    bool prefixLevel;
+
+public:
+    long long messages = 0;
+    long long bytes = 0;
+
+    CountingLogger(LogLevel minimum, bool prefix) : BaseLogger(minimum), prefixLevel(prefix) {}
+
+    ~CountingLogger() {}
+
+    void log(LogLevel level, std::string_view message) override
+    {
+        if (level < minimumLevel)
+        {
+            return;
+        }
+        std::string_view text = prefixLevel ? format(level, message) : message;
+        messages++;
+        bytes += (long long)text.size();
     }
 };
 
-int main()
+// Times count messages (1 in 4 below the Info threshold) through logger
+template <typename Logger>
+double nanosecondsPerMessage(Logger &logger, long long count)
+{
+    const std::string_view message = "request handled";
+    const LogLevel levels[4] = {LogLevel::Debug, LogLevel::Info, LogLevel::Warning, LogLevel::Error};
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < count; i++)
+    {
+        logger.log(levels[i & 3], message);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+// Sends the same message stream through a virtual BaseLogger*, a StaticLogger
+// and an AnyLogger, all counting only. Run once with "[LEVEL] " formatting and
+// once without, so the dispatch cost is visible on its own.
+template <typename Format>
+void runDispatchBenchmark(const char *label, bool prefix, long long count)
+{
+    // The pointer is chosen at run time so the compiler cannot devirtualize it
+    std::vector<std::unique_ptr<BaseLogger>> choices;
+    choices.push_back(std::make_unique<CountingLogger>(LogLevel::Info, prefix));
+    volatile size_t pick = 0;
+    BaseLogger *virtualLogger = choices[pick].get();
+
+    typedef StaticLogger<MinLevel<LogLevel::Info>, Format, CountingSink> CountingStaticLogger;
+    CountingStaticLogger staticLogger;
+    AnyLogger anyLogger{CountingStaticLogger()};
+
+    double virtualNs = nanosecondsPerMessage(*virtualLogger, count);
+    double staticNs = nanosecondsPerMessage(staticLogger, count);
+    double anyNs = nanosecondsPerMessage(anyLogger, count);
+
+    std::cout << "\n--- Dispatch benchmark, " << label << " (" << count << " messages, 1 in 4 filtered) ---\n";
+    printf("  virtual BaseLogger* : %6.2f ns/message (%lld written)\n", virtualNs,
+           static_cast<CountingLogger *>(virtualLogger)->messages);
+    printf("  StaticLogger        : %6.2f ns/message (%lld written)\n", staticNs, staticLogger.template sink<0>().messages);
+    printf("  AnyLogger           : %6.2f ns/message\n", anyNs);
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
 {
     // Create derived class objects through base class pointers (polymorphism)
     BaseLogger *fl = new FileLogger();
@@ -101,5 +232,40 @@ int main()
 
     std::cout << "\nDestruction complete. Notice how derived destructors are called before base destructor." << std::endl;
 
+    // Run-time polymorphism: one virtual call per message
+    std::cout << "\n--- Logging through BaseLogger* (virtual dispatch) ---" << std::endl;
+    {
+        std::unique_ptr<BaseLogger> logger = std::make_unique<ConsoleLogger>(LogLevel::Info);
+        logger->log(LogLevel::Debug, "filtered out, but only after the virtual call");
+        logger->log(LogLevel::Info, "hello from ConsoleLogger");
+    }
+
+    // Compile-time polymorphism: sinks, format and filter fixed by the type
+    std::cout << "\n--- Logging through StaticLogger (static dispatch) ---" << std::endl;
+    {
+        StaticLogger<MinLevel<LogLevel::Info>, LevelPrefixFormat, ConsoleSink, FileSink> logger(
+            ConsoleSink(), FileSink("logger_demo.log"));
+        logger.log(LogLevel::Debug, "removed at compile time");
+        logger.log(LogLevel::Warning, "hello from StaticLogger (console + logger_demo.log)");
+    }
+
+    // Run-time choice without a class hierarchy
+    std::cout << "\n--- Logging through AnyLogger (type-erased) ---" << std::endl;
+    {
+        bool verbose = argc > 1 && std::string(argv[1]) == "--verbose";
+        AnyLogger logger = verbose
+                               ? AnyLogger(StaticLogger<AcceptAll, LevelPrefixFormat, ConsoleSink>())
+                               : AnyLogger(StaticLogger<MinLevel<LogLevel::Warning>, PlainFormat, ConsoleSink>());
+        logger.log(LogLevel::Info, "shown only with --verbose");
+        logger.log(LogLevel::Error, "logger chosen at run time");
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+    {
+        long long count = argc > 2 ? std::stoll(argv[2]) : 50000000;
+        runDispatchBenchmark<PlainFormat>("plain messages", false, count);
+        runDispatchBenchmark<LevelPrefixFormat>("[LEVEL] prefix", true, count);
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -55,7 +55,8 @@ Date: February 2026
 #include <iostream>
 #include <vector>
 #include <stdexcept>
-#include <iomanip>
+#include <charconv>
+#include "../../Module4/18_IOStreams/TableFormatter.h"
 
 using namespace std;
 
@@ -73,6 +74,42 @@ protected:
     int cols;
     vector<vector<double>> data;
 
+    // Prints the elements as an aligned table. Column widths come from the
+    // widest value in each column and the whole matrix is written at once.
+    // With markDiagonal, diagonal values are shown as [x].
+    void printElements(bool markDiagonal) const
+    {
+        TableFormatter table;
+        table.setShowHeader(false);
+        table.setDecorations("| ", " ", " |");
+        for (int j = 0; j < cols; j++)
+        {
+            table.addColumn("", TableFormatter::Right, 2);
+        }
+        table.reserveRows(rows);
+
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = 0; j < cols; j++)
+            {
+                if (!markDiagonal)
+                {
+                    table.cell(data[i][j]);
+                    continue;
+                }
+                // Pad off-diagonal values by one character on each side so
+                // they line up with the bracketed diagonal
+                char text[64];
+                text[0] = (i == j) ? '[' : ' ';
+                char *end = to_chars(text + 1, text + sizeof(text) - 1, data[i][j], chars_format::fixed, 2).ptr;
+                *end++ = (i == j) ? ']' : ' ';
+                table.cell(string_view(text, end - text));
+            }
+            table.endRow();
+        }
+        table.print(cout);
+    }
+
 public:
     // Constructor
     Matrix(int r, int c) : rows(r), cols(c)
@@ -91,17 +128,9 @@ public:
     // Can be overridden by derived classes for custom display behavior
     virtual void display() const
     {
-        cout << "\n=== Matrix (" << rows << "x" << cols << ") ===" << endl;
-        for (int i = 0; i < rows; i++)
-        {
-            cout << "| ";
-            for (int j = 0; j < cols; j++)
-            {
-                cout << setw(8) << fixed << setprecision(2) << data[i][j] << " ";
-            }
-            cout << "|" << endl;
-        }
-        cout << "==================" << endl;
+        cout << "\n=== Matrix (" << rows << "x" << cols << ") ===\n";
+        printElements(false);
+        cout << "==================\n";
     }
 
     // COMPILE-TIME POLYMORPHISM: Function Overloading
@@ -196,16 +225,8 @@ public:
             cout << "Warning: Matrix is not square!" << endl;
         }
 
-        for (int i = 0; i < rows; i++)
-        {
-            cout << "| ";
-            for (int j = 0; j < cols; j++)
-            {
-                cout << setw(8) << fixed << setprecision(2) << data[i][j] << " ";
-            }
-            cout << "|" << endl;
-        }
-        cout << "========================" << endl;
+        printElements(false);
+        cout << "========================\n";
     }
 
     // Additional method to get diagonal elements
@@ -254,27 +275,12 @@ public:
     // Custom display highlighting identity matrix properties
     void display() const override
     {
-        cout << "\n=== Identity Matrix (" << rows << "x" << cols << ") ===" << endl;
-        cout << "Properties: All diagonal elements = 1, All other elements = 0" << endl;
+        cout << "\n=== Identity Matrix (" << rows << "x" << cols << ") ===\n";
+        cout << "Properties: All diagonal elements = 1, All other elements = 0\n";
 
-        for (int i = 0; i < rows; i++)
-        {
-            cout << "| ";
-            for (int j = 0; j < cols; j++)
-            {
-                if (i == j)
-                {
-                    // Highlight diagonal with different formatting
-                    cout << setw(8) << fixed << setprecision(2) << "[" << data[i][j] << "]";
-                }
-                else
-                {
-                    cout << setw(8) << fixed << setprecision(2) << data[i][j] << " ";
-                }
-            }
-            cout << " |" << endl;
-        }
-        cout << "========================" << endl;
+        // Highlight diagonal with different formatting
+        printElements(true);
+        cout << "========================\n";
     }
 
     // Verify if matrix maintains identity property
@@ -0,0 +1,218 @@
+// StaticLogger.h - Compile-time (policy-based) counterpart of the BaseLogger hierarchy
+//
+// BaseLogger uses RUN-TIME polymorphism: every message through a BaseLogger*
+// is an indirect call the compiler cannot inline, and filtering happens only
+// after the call has been made.
+//
+// StaticLogger uses COMPILE-TIME polymorphism instead. A logger is assembled
+// from three kinds of policy classes chosen as template arguments:
+//   Filter  - static bool accept(LogLevel)     decides which messages pass
+//   Format  - std::string_view format(LogLevel, std::string_view, std::string &buffer)
+//   Sinks   - void write(std::string_view)     one or more destinations
+// Everything is resolved at compile time, so a filtered-out message costs a
+// constant comparison and the sink writes can be inlined.
+//
+// When the concrete logger type must be chosen at run time (e.g. from a
+// config file), wrap it in AnyLogger: one indirect call per message, and the
+// policies inside are still fully inlined.
+//
+// Usage:
+//   StaticLogger<MinLevel<LogLevel::Info>, LevelPrefixFormat, ConsoleSink, FileSink> logger(
+//       ConsoleSink(), FileSink("app.log"));
+//   logger.log(LogLevel::Warning, "disk almost full");
+//
+//   AnyLogger any(std::move(logger));
+//   any.log(LogLevel::Error, "chosen at run time");
+
+#ifndef STATIC_LOGGER_H
+#define STATIC_LOGGER_H
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+enum class LogLevel
+{
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+inline const char *levelName(LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel::Debug:
+        return "DEBUG";
+    case LogLevel::Info:
+        return "INFO";
+    case LogLevel::Warning:
+        return "WARNING";
+    default:
+        return "ERROR";
+    }
+}
+
+// ----- Filters -----
+
+struct AcceptAll
+{
+    static constexpr bool accept(LogLevel) { return true; }
+};
+
+template <LogLevel Minimum>
+struct MinLevel
+{
+    static constexpr bool accept(LogLevel level) { return level >= Minimum; }
+};
+
+// ----- Formatters -----
+
+// Passes the message through untouched (no copy)
+struct PlainFormat
+{
+    static std::string_view format(LogLevel, std::string_view message, std::string &)
+    {
+        return message;
+    }
+};
+
+// "[LEVEL] message", built in the logger's reusable buffer
+struct LevelPrefixFormat
+{
+    static std::string_view format(LogLevel level, std::string_view message, std::string &buffer)
+    {
+        buffer.clear();
+        buffer += '[';
+        buffer += levelName(level);
+        buffer += "] ";
+        buffer += message;
+        return buffer;
+    }
+};
+
+// ----- Sinks -----
+
+// Same destination as ConsoleLogger: standard output, one line per message
+struct ConsoleSink
+{
+    void write(std::string_view text)
+    {
+        fwrite(text.data(), 1, text.size(), stdout);
+        fputc('\n', stdout);
+    }
+};
+
+// Same destination as FileLogger: appends one line per message to a file.
+// Move-only; the file is closed when the sink is destroyed.
+class FileSink
+{
+    FILE *file;
+
+public:
+    explicit FileSink(const char *fileName) : file(fopen(fileName, "a")) {}
+    FileSink(FileSink &&other) noexcept : file(other.file) { other.file = nullptr; }
+    FileSink(const FileSink &) = delete;
+    FileSink &operator=(const FileSink &) = delete;
+    ~FileSink()
+    {
+        if (file != nullptr)
+            fclose(file);
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    void write(std::string_view text)
+    {
+        if (file == nullptr)
+            return;
+        fwrite(text.data(), 1, text.size(), file);
+        fputc('\n', file);
+    }
+};
+
+// Counts messages and bytes without doing any I/O (useful for benchmarks)
+struct CountingSink
+{
+    long long messages = 0;
+    long long bytes = 0;
+
+    void write(std::string_view text)
+    {
+        messages++;
+        bytes += (long long)text.size();
+    }
+};
+
+// ----- Logger -----
+
+template <typename Filter, typename Format, typename... Sinks>
+class StaticLogger
+{
+    std::tuple<Sinks...> sinks;
+    std::string buffer;
+
+public:
+    StaticLogger() = default;
+    explicit StaticLogger(Sinks... s) : sinks(std::move(s)...) {}
+
+    void log(LogLevel level, std::string_view message)
+    {
+        if (!Filter::accept(level))
+            return;
+        std::string_view text = Format::format(level, message, buffer);
+        std::apply([text](Sinks &...sink)
+                   { (sink.write(text), ...); },
+                   sinks);
+    }
+
+    template <size_t Index>
+    auto &sink() { return std::get<Index>(sinks); }
+};
+
+// ----- Type-erased adapter -----
+
+// Holds any logger with a log(LogLevel, string_view) member. The only
+// indirection is one call through a function pointer; there is no class
+// hierarchy and the wrapped logger keeps its inlined policies.
+class AnyLogger
+{
+    void *object = nullptr;
+    void (*logFn)(void *, LogLevel, std::string_view) = nullptr;
+    void (*destroyFn)(void *) = nullptr;
+
+public:
+    template <typename Logger, typename = std::enable_if_t<!std::is_same_v<Logger, AnyLogger>>>
+    explicit AnyLogger(Logger logger)
+        : object(new Logger(std::move(logger))),
+          logFn([](void *p, LogLevel level, std::string_view message)
+                { static_cast<Logger *>(p)->log(level, message); }),
+          destroyFn([](void *p)
+                    { delete static_cast<Logger *>(p); })
+    {
+    }
+
+    AnyLogger(AnyLogger &&other) noexcept
+        : object(other.object), logFn(other.logFn), destroyFn(other.destroyFn)
+    {
+        other.object = nullptr;
+    }
+
+    AnyLogger(const AnyLogger &) = delete;
+    AnyLogger &operator=(const AnyLogger &) = delete;
+
+    ~AnyLogger()
+    {
+        if (object != nullptr)
+            destroyFn(object);
+    }
+
+    void log(LogLevel level, std::string_view message) { logFn(object, level, message); }
+};
+
+#endif // STATIC_LOGGER_H
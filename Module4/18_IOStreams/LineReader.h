@@ -0,0 +1,276 @@
+// LineReader.h - Zero-copy line iteration for large text files
+//
+// std::getline copies every line into a std::string (and may reallocate it).
+// LineReader instead hands out std::string_view lines that point straight into
+// the file data:
+//   - Regular files are memory-mapped, so the page cache is the buffer.
+//   - Anything mmap cannot handle (pipes, /proc files, empty files, non-POSIX
+//     systems) is streamed in large chunks through one reusable buffer.
+// Newlines are found with memchr, which glibc implements with SSE2/AVX2/EVEX
+// depending on the CPU, so no hand-written SIMD is needed here.
+//
+// Lines never include the '\n'; a trailing '\r' (CRLF files) is dropped too,
+// and a last line without a newline is still returned.
+//
+// Usage:
+//   LineReader reader("app.log");
+//   string_view line;
+//   while (reader.next(line)) { ... }
+//
+//   // Parallel: the mapped file is split into one chunk per thread at line
+//   // boundaries; fn(chunkIndex, line) is called from the worker threads
+//   forEachLineParallel("app.log", 8, [&](unsigned chunk, string_view line) { ... });
+//
+// A string_view is only valid until the next call to next() in streaming mode,
+// and until the reader is destroyed in mapped mode.
+
+#ifndef LINE_READER_H
+#define LINE_READER_H
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LINE_READER_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const size_t LINE_READER_CHUNK_SIZE = 4 << 20;
+
+// Splits [begin, end) into lines; shared by the mapped, streamed and parallel paths
+class LineCursor
+{
+    const char *pos;
+    const char *end;
+
+public:
+    LineCursor(const char *begin = nullptr, const char *finish = nullptr) : pos(begin), end(finish) {}
+
+    bool next(std::string_view &line)
+    {
+        if (pos >= end)
+            return false;
+        const char *newline = (const char *)memchr(pos, '\n', end - pos);
+        const char *lineEnd = newline ? newline : end;
+        const char *last = lineEnd;
+        if (last > pos && last[-1] == '\r')
+            last--;
+        line = std::string_view(pos, last - pos);
+        pos = newline ? newline + 1 : end;
+        return true;
+    }
+};
+
+// Parses a line that holds one number, optionally surrounded by spaces or
+// tabs, with from_chars (no locale, no stream state). False if anything else
+// is on the line.
+template <typename Number>
+bool parseNumberField(std::string_view field, Number &value)
+{
+    size_t first = field.find_first_not_of(" \t");
+    if (first == std::string_view::npos)
+        return false;
+    size_t last = field.find_last_not_of(" \t");
+    const char *begin = field.data() + first;
+    const char *end = field.data() + last + 1;
+    return std::from_chars(begin, end, value).ptr == end;
+}
+
+class LineReader
+{
+    bool opened = false;
+    bool failed = false;
+    long long lines = 0;
+
+    // Mapped mode
+    const char *mapped = nullptr;
+    size_t mappedSize = 0;
+    LineCursor cursor;
+
+    // Streaming mode
+    FILE *file = nullptr;
+    std::vector<char> buffer;
+    size_t start = 0;
+    size_t filled = 0;
+    bool atEof = false;
+
+    bool tryMap(const std::string &path)
+    {
+#ifdef LINE_READER_HAVE_MMAP
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED)
+            return false;
+        madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+        mapped = (const char *)p;
+        mappedSize = (size_t)st.st_size;
+        cursor = LineCursor(mapped, mapped + mappedSize);
+        return true;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+    // Streaming mode: refill after moving the unfinished line to the front.
+    // The buffer doubles if a single line is longer than it.
+    bool refill()
+    {
+        if (start > 0)
+        {
+            memmove(buffer.data(), buffer.data() + start, filled - start);
+            filled -= start;
+            start = 0;
+        }
+        if (filled == buffer.size())
+            buffer.resize(buffer.size() * 2);
+        size_t got = fread(buffer.data() + filled, 1, buffer.size() - filled, file);
+        if (got == 0)
+        {
+            atEof = true;
+            failed = ferror(file) != 0;
+        }
+        filled += got;
+        return got > 0;
+    }
+
+    bool nextStreamed(std::string_view &line)
+    {
+        while (true)
+        {
+            const char *base = buffer.data();
+            const char *newline = (const char *)memchr(base + start, '\n', filled - start);
+            if (newline != nullptr || (atEof && start < filled))
+            {
+                const char *lineStart = base + start;
+                const char *lineEnd = newline ? newline : base + filled;
+                start = newline ? (size_t)(newline - base) + 1 : filled;
+                if (lineEnd > lineStart && lineEnd[-1] == '\r')
+                    lineEnd--;
+                line = std::string_view(lineStart, lineEnd - lineStart);
+                return true;
+            }
+            if (atEof || !refill())
+            {
+                if (atEof && start < filled)
+                    continue;
+                return false;
+            }
+        }
+    }
+
+public:
+    explicit LineReader(const std::string &path)
+    {
+        if (tryMap(path))
+        {
+            opened = true;
+            return;
+        }
+        file = fopen(path.c_str(), "rb");
+        if (file != nullptr)
+        {
+            opened = true;
+            buffer.resize(LINE_READER_CHUNK_SIZE);
+        }
+    }
+
+    ~LineReader()
+    {
+#ifdef LINE_READER_HAVE_MMAP
+        if (mapped != nullptr)
+            munmap((void *)mapped, mappedSize);
+#endif
+        if (file != nullptr)
+            fclose(file);
+    }
+
+    LineReader(const LineReader &) = delete;
+    LineReader &operator=(const LineReader &) = delete;
+
+    bool isOpen() const { return opened; }
+    // True if a read error (not end of file) stopped the iteration
+    bool hadError() const { return failed; }
+    bool isMapped() const { return mapped != nullptr; }
+    long long lineNumber() const { return lines; }
+
+    // Mapped mode only: the whole file, for callers that split it themselves
+    std::string_view contents() const { return std::string_view(mapped, mappedSize); }
+
+    bool next(std::string_view &line)
+    {
+        bool got = mapped != nullptr ? cursor.next(line) : (file != nullptr && nextStreamed(line));
+        if (got)
+            lines++;
+        return got;
+    }
+};
+
+// Calls fn(chunkIndex, line) for every line, splitting a mapped file into
+// `threads` chunks cut at line boundaries. Chunk i holds lines that come before
+// those of chunk i + 1, so per-chunk results can be merged in file order.
+// Falls back to a single sequential pass (chunk 0) if the file is not mappable.
+// Returns false if the file could not be opened or read.
+template <typename Fn>
+bool forEachLineParallel(const std::string &path, unsigned threads, Fn fn)
+{
+    LineReader reader(path);
+    if (!reader.isOpen())
+        return false;
+
+    if (!reader.isMapped() || threads <= 1)
+    {
+        std::string_view line;
+        while (reader.next(line))
+            fn(0u, line);
+        return !reader.hadError();
+    }
+
+    std::string_view all = reader.contents();
+    const char *begin = all.data();
+    const char *end = begin + all.size();
+
+    std::vector<const char *> cuts(threads + 1, end);
+    cuts[0] = begin;
+    for (unsigned t = 1; t < threads; t++)
+    {
+        const char *cut = begin + all.size() / threads * t;
+        if (cut < cuts[t - 1])
+            cut = cuts[t - 1];
+        const char *newline = (const char *)memchr(cut, '\n', end - cut);
+        cuts[t] = newline ? newline + 1 : end;
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]()
+                             {
+            LineCursor chunk(cuts[t], cuts[t + 1]);
+            std::string_view line;
+            while (chunk.next(line))
+                fn(t, line); });
+    }
+    for (std::thread &worker : workers)
+        worker.join();
+    return true;
+}
+
+#endif // LINE_READER_H
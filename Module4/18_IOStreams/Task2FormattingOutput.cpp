@@ -3,6 +3,9 @@
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <vector>
+#include <chrono>
+#include "TableFormatter.h"
 
 struct Item
 {
@@ -10,14 +13,10 @@ struct Item
     double price;
 };
 
-int main()
+// Classic version: widths measured with ostringstream, every field formatted
+// through std::setw/std::fixed/std::setprecision on the stream.
+void printWithManipulators(const Item *items, int itemCount)
 {
-    Item items[] = {
-        {"Apple", 1.50},
-        {"Banana", 0.99},
-        {"Orange", 2.25}};
-
-    const int itemCount = sizeof(items) / sizeof(items[0]);
     const int padding = 3;
     int itemWidth = static_cast<int>(std::string("Item").length()) + padding;
     int priceWidth = static_cast<int>(std::string("Price").length()) + padding;
@@ -43,13 +42,79 @@ int main()
               << std::right << std::setw(priceWidth) << "Price" << '\n';
     std::cout << std::string(itemWidth + priceWidth, '-') << '\n';
 
-    for (const Item &item : items)
+    for (int index = 0; index < itemCount; ++index)
     {
         // std::fixed + std::setprecision(2) prints money with 2 decimals.
-        std::cout << std::left << std::setw(itemWidth) << item.name
+        std::cout << std::left << std::setw(itemWidth) << items[index].name
                   << std::right << std::setw(priceWidth) << std::fixed << std::setprecision(2)
-                  << item.price << '\n';
+                  << items[index].price << '\n';
+    }
+}
+
+// Same table through TableFormatter: prices go through std::to_chars, column
+// widths come from a pre-pass over the formatted cells, and the output is
+// written in large blocks.
+void printWithFormatter(const Item *items, int itemCount)
+{
+    TableFormatter table;
+    table.addColumn("Item", TableFormatter::Left)
+        .addColumn("Price", TableFormatter::Right, 2)
+        .setDecorations("", "   ", "");
+    table.reserveRows(itemCount);
+
+    for (int index = 0; index < itemCount; ++index)
+    {
+        table.cell(items[index].name).cell(items[index].price).endRow();
+    }
+    table.print(std::cout);
+}
+
+// Prints a generated report both ways and reports the timings on stderr.
+// Run as: ./a.out --bench [rows] > /dev/null
+void runReportBenchmark(int rows)
+{
+    std::vector<Item> items;
+    items.reserve(rows);
+    for (int index = 0; index < rows; ++index)
+    {
+        items.push_back({"Product " + std::to_string(index), 0.5 + (index % 100000) / 7.0});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    printWithManipulators(items.data(), rows);
+    std::cout.flush();
+    double manipulatorSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    printWithFormatter(items.data(), rows);
+    std::cout.flush();
+    double formatterSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cerr << rows << " rows\n"
+              << "  setw/setprecision : " << manipulatorSeconds * 1000 << " ms\n"
+              << "  TableFormatter    : " << formatterSeconds * 1000 << " ms\n";
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+    {
+        runReportBenchmark(argc > 2 ? std::stoi(argv[2]) : 1000000);
+        return 0;
     }
 
+    Item items[] = {
+        {"Apple", 1.50},
+        {"Banana", 0.99},
+        {"Orange", 2.25}};
+
+    const int itemCount = sizeof(items) / sizeof(items[0]);
+
+    std::cout << "With stream manipulators:\n";
+    printWithManipulators(items, itemCount);
+
+    std::cout << "\nWith TableFormatter:\n";
+    printWithFormatter(items, itemCount);
+
     return 0;
 }
@@ -1,9 +1,66 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include "LineReader.h"
 
-int main()
+// Scans a (possibly multi-GB) text file and prints line statistics.
+// Each thread counts its own chunk; the totals are merged afterwards.
+int printFileStats(const std::string &filename, unsigned threads)
 {
+    // alignas keeps each thread's counters on its own cache line
+    struct alignas(64) ChunkStats
+    {
+        long long lines = 0;
+        long long bytes = 0;
+        size_t longest = 0;
+    };
+    std::vector<ChunkStats> stats(threads);
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = forEachLineParallel(filename, threads, [&](unsigned chunk, std::string_view line)
+                                  {
+        ChunkStats &s = stats[chunk];
+        s.lines++;
+        s.bytes += (long long)line.size();
+        if (line.size() > s.longest)
+            s.longest = line.size(); });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!ok)
+    {
+        std::cout << "Error in reading file." << std::endl;
+        return 1;
+    }
+
+    ChunkStats total;
+    for (const ChunkStats &s : stats)
+    {
+        total.lines += s.lines;
+        total.bytes += s.bytes;
+        if (s.longest > total.longest)
+            total.longest = s.longest;
+    }
+    std::cout << "Lines        : " << total.lines << '\n'
+              << "Text bytes   : " << total.bytes << '\n'
+              << "Longest line : " << total.longest << '\n'
+              << "Threads      : " << threads << '\n'
+              << "Time         : " << seconds << " s" << std::endl;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    // ./a.out --stats big.log [threads] scans an existing file instead
+    if (argc > 2 && std::string(argv[1]) == "--stats")
+    {
+        unsigned threads = argc > 3 ? (unsigned)std::stoul(argv[3]) : std::thread::hardware_concurrency();
+        return printFileStats(argv[2], threads > 0 ? threads : 1);
+    }
+
     std::string filename;
 
     // Read target filename from user.
@@ -38,19 +95,22 @@ int main()
 
     std::cout << "Reading from file..." << std::endl;
 
-    // std::ifstream opens file for reading.
-    std::ifstream inputfile(filename);
-    if (!inputfile)
+    // LineReader maps the file and yields each line as a string_view,
+    // without copying it into a std::string first.
+    LineReader inputfile(filename);
+    if (!inputfile.isOpen())
     {
         std::cout << "Error in opening file." << std::endl;
         return 1;
     }
 
     std::cout << "\nFile contents:" << std::endl;
-    while (std::getline(inputfile, line))
+    std::string_view view;
+    while (inputfile.next(view))
     {
-        std::cout << line << std::endl;
+        std::cout << view << '\n';
     }
+    std::cout.flush();
 
     return 0;
 }
\ No newline at end of file
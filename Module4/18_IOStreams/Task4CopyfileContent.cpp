@@ -1,53 +1,442 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#endif
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#endif
 using namespace std;
 
+// The copy engine works on raw bytes, so binary files and CRLF line endings
+// survive unchanged (the old getline loop rewrote every line ending to '\n').
+//
+// Strategies, fastest first:
+//   1. reflink (FICLONE)       - share extents on CoW filesystems, no data moves
+//   2. copy_file_range         - in-kernel copy, parallel ranges for big files
+//   3. sendfile                - in-kernel copy for older kernels
+//   4. buffered double-buffer  - read the next chunk while writing this one
+// Asking for a CRC32C forces strategy 4, because the bytes must pass through
+// user space to be checksummed. All four are driven by the file size, so they
+// are only used for regular files that report one; pipes, FIFOs, devices and
+// /proc-style files (size 0) are copied with plain read/write until EOF.
+
+const size_t COPY_CHUNK_SIZE = 8 << 20;             // 8 MB per read/write
+const size_t BUFFER_ALIGNMENT = 4096;               // page-aligned buffers
+const long long PARALLEL_THRESHOLD = 256LL << 20;   // split files above 256 MB
+
+struct CopyResult
+{
+    bool ok = false;
+    long long bytes = 0;
+    string method;
+    bool haveCrc = false;
+    uint32_t crc = 0;
+};
+
+// ----- CRC32C (Castagnoli) -----
+
+static uint32_t crc32cTable[256];
+
+static void initCrc32cTable()
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+            c = (c & 1) ? 0x82F63B78u ^ (c >> 1) : c >> 1;
+        crc32cTable[i] = c;
+    }
+}
+
+static uint32_t crc32cSoftware(uint32_t crc, const unsigned char *p, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        crc = crc32cTable[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// Uses the SSE4.2 crc32 instruction; only called after a runtime CPU check
+__attribute__((target("sse4.2"))) static uint32_t crc32cHardware(uint32_t crc, const unsigned char *p, size_t n)
+{
+    uint64_t c = crc;
+    while (n >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        c = _mm_crc32_u64(c, word);
+        p += 8;
+        n -= 8;
+    }
+    uint32_t c32 = (uint32_t)c;
+    while (n-- > 0)
+        c32 = _mm_crc32_u8(c32, *p++);
+    return c32;
+}
+#endif
+
+// Running CRC: start with 0, feed chunks in order
+uint32_t crc32cUpdate(uint32_t crc, const void *data, size_t n)
+{
+    crc = ~crc;
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    static const bool hasSse42 = __builtin_cpu_supports("sse4.2");
+    if (hasSse42)
+        return ~crc32cHardware(crc, (const unsigned char *)data, n);
+#endif
+    return ~crc32cSoftware(crc, (const unsigned char *)data, n);
+}
+
+// ----- helpers -----
+
+static ssize_t readFull(int fd, char *buf, size_t n, off_t offset)
+{
+    size_t total = 0;
+    while (total < n)
+    {
+        ssize_t r = pread(fd, buf + total, n - total, offset + (off_t)total);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r < 0)
+            return -1;
+        if (r == 0)
+            break;
+        total += (size_t)r;
+    }
+    return (ssize_t)total;
+}
+
+static bool writeFull(int fd, const char *buf, size_t n, off_t offset)
+{
+    while (n > 0)
+    {
+        ssize_t w = pwrite(fd, buf, n, offset);
+        if (w < 0 && errno == EINTR)
+            continue;
+        if (w <= 0)
+            return false;
+        buf += w;
+        offset += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+struct AlignedBuffer
+{
+    char *data;
+    explicit AlignedBuffer(size_t n) : data((char *)aligned_alloc(BUFFER_ALIGNMENT, n)) {}
+    ~AlignedBuffer() { free(data); }
+    AlignedBuffer(const AlignedBuffer &) = delete;
+    AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+};
+
+// Copies [offset, offset + length) with pread/pwrite through one buffer
+static bool copyRangeBuffered(int in, int out, off_t offset, long long length)
+{
+    AlignedBuffer buffer(COPY_CHUNK_SIZE);
+    if (buffer.data == nullptr)
+        return false;
+    while (length > 0)
+    {
+        size_t want = (size_t)min<long long>(length, (long long)COPY_CHUNK_SIZE);
+        ssize_t got = readFull(in, buffer.data, want, offset);
+        if (got <= 0 || !writeFull(out, buffer.data, (size_t)got, offset))
+            return false;
+        offset += got;
+        length -= got;
+    }
+    return true;
+}
+
+// Double-buffered copy: the next chunk is read on another thread while the
+// current one is checksummed and written
+static bool copyDoubleBuffered(int in, int out, CopyResult &result, bool withCrc)
+{
+    AlignedBuffer first(COPY_CHUNK_SIZE), second(COPY_CHUNK_SIZE);
+    if (first.data == nullptr || second.data == nullptr)
+        return false;
+
+    char *buffers[2] = {first.data, second.data};
+    int current = 0;
+    off_t offset = 0;
+    uint32_t crc = 0;
+
+    future<ssize_t> pending = async(launch::async, readFull, in, buffers[current], COPY_CHUNK_SIZE, offset);
+    while (true)
+    {
+        ssize_t got = pending.get();
+        if (got < 0)
+            return false;
+        if (got == 0)
+            break;
+
+        int next = 1 - current;
+        pending = async(launch::async, readFull, in, buffers[next], COPY_CHUNK_SIZE, offset + got);
+
+        if (withCrc)
+            crc = crc32cUpdate(crc, buffers[current], (size_t)got);
+        if (!writeFull(out, buffers[current], (size_t)got, offset))
+        {
+            pending.wait();
+            return false;
+        }
+
+        offset += got;
+        current = next;
+    }
+
+    result.bytes = offset;
+    result.haveCrc = withCrc;
+    result.crc = crc;
+    return true;
+}
+
+// Sequential copy for inputs without a usable size or offsets (pipes, FIFOs,
+// character devices, /proc files): read until EOF, write everything read
+static bool copyStream(int in, int out, CopyResult &result, bool withCrc)
+{
+    AlignedBuffer buffer(1 << 20);
+    if (buffer.data == nullptr)
+        return false;
+
+    long long total = 0;
+    uint32_t crc = 0;
+    while (true)
+    {
+        ssize_t got = read(in, buffer.data, 1 << 20);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got < 0)
+            return false;
+        if (got == 0)
+            break;
+        if (withCrc)
+            crc = crc32cUpdate(crc, buffer.data, (size_t)got);
+        for (ssize_t done = 0; done < got;)
+        {
+            ssize_t w = write(out, buffer.data + done, (size_t)(got - done));
+            if (w < 0 && errno == EINTR)
+                continue;
+            if (w <= 0)
+                return false;
+            done += w;
+        }
+        total += got;
+    }
+
+    result.bytes = total;
+    result.haveCrc = withCrc;
+    result.crc = crc;
+    return true;
+}
+
+#ifdef __linux__
+// Kernel-side copy of one range. Returns false with errno set if the
+// filesystem pair does not support copy_file_range.
+static bool copyRangeKernel(int in, int out, off_t offset, long long length)
+{
+    loff_t inOffset = offset, outOffset = offset;
+    while (length > 0)
+    {
+        ssize_t n = copy_file_range(in, &inOffset, out, &outOffset, (size_t)min<long long>(length, 1LL << 30), 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        length -= n;
+    }
+    return true;
+}
+
+// Splits the file into one range per thread; each range uses copy_file_range
+// and falls back to pread/pwrite on its own if the kernel refuses
+static bool copyParallel(int in, int out, long long size, int threads)
+{
+    if (ftruncate(out, size) != 0)
+        return false;
+
+    long long perThread = (size / threads + COPY_CHUNK_SIZE - 1) / COPY_CHUNK_SIZE * COPY_CHUNK_SIZE;
+    vector<future<bool>> parts;
+    for (long long start = 0; start < size; start += perThread)
+    {
+        long long length = min(perThread, size - start);
+        parts.push_back(async(launch::async, [=]()
+                              { return copyRangeKernel(in, out, start, length) ||
+                                       copyRangeBuffered(in, out, start, length); }));
+    }
+
+    bool ok = true;
+    for (future<bool> &part : parts)
+        ok = part.get() && ok;
+    return ok;
+}
+#endif
+
+// Copies source to destination byte-for-byte using the fastest available strategy
+CopyResult copyFile(const string &source, const string &destination, bool withCrc)
+{
+    CopyResult result;
+
+    int in = open(source.c_str(), O_RDONLY);
+    if (in < 0)
+    {
+        result.method = "could not open input file";
+        return result;
+    }
+
+    struct stat st;
+    if (fstat(in, &st) != 0)
+    {
+        close(in);
+        result.method = "could not stat input file";
+        return result;
+    }
+    long long size = st.st_size;
+
+    int out = open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC, st.st_mode & 0777);
+    if (out < 0)
+    {
+        close(in);
+        result.method = "could not open output file";
+        return result;
+    }
+
+    if (!S_ISREG(st.st_mode) || size == 0)
+    {
+        result.ok = copyStream(in, out, result, withCrc);
+        result.method = "sequential read/write";
+        close(in);
+        if (close(out) != 0)
+            result.ok = false;
+        return result;
+    }
+
+#ifdef __linux__
+    posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    if (!withCrc)
+    {
+        if (ioctl(out, FICLONE, in) == 0)
+        {
+            result.ok = true;
+            result.method = "reflink";
+        }
+        else if (size >= PARALLEL_THRESHOLD && thread::hardware_concurrency() > 1)
+        {
+            int threads = (int)min(thread::hardware_concurrency(), 8u);
+            result.ok = copyParallel(in, out, size, threads);
+            result.method = "parallel copy_file_range (" + to_string(threads) + " threads)";
+        }
+        else if (copyRangeKernel(in, out, 0, size))
+        {
+            result.ok = true;
+            result.method = "copy_file_range";
+        }
+        else
+        {
+            // copy_file_range may have moved part of the file; sendfile resumes
+            // from wherever the output currently ends
+            off_t offset = lseek(out, 0, SEEK_END);
+            bool ok = offset >= 0;
+            while (ok && offset < size)
+            {
+                ssize_t n = sendfile(out, in, &offset, (size_t)min<long long>(size - offset, 1LL << 30));
+                ok = n > 0 || (n < 0 && errno == EINTR);
+            }
+            if (ok)
+            {
+                result.ok = true;
+                result.method = "sendfile";
+            }
+        }
+
+        if (result.ok)
+            result.bytes = size;
+    }
+#endif
+
+    if (!result.ok)
+    {
+        if (ftruncate(out, 0) == 0)
+        {
+            result.ok = copyDoubleBuffered(in, out, result, withCrc);
+        }
+        result.method = "double-buffered read/write";
+    }
+
+    close(in);
+    if (close(out) != 0)
+        result.ok = false;
+    return result;
+}
+
 int main()
 {
+    initCrc32cTable();
+
     // Step 1: Read source file name from user.
     // Source file path (file to read).
     string inputfile;
     cout << "Enter the input file name: " << endl;
     getline(cin, inputfile);
 
-    // Open source file using ifstream (input/read stream).
-    ifstream inputstream(inputfile);
-    if (!inputstream)
-    {
-        cout << "Error: could not open input file '" << inputfile << "'" << endl;
-        return 1;
-    }
-
     // Step 2: Read destination file name from user.
     // Destination file path (file to write).
     string outputfile;
     cout << "Enter the output file name: " << endl;
     getline(cin, outputfile);
 
-    // Open/create destination file using ofstream (output/write stream).
-    ofstream outputstream(outputfile);
-    if (!outputstream)
-    {
-        cout << "Error: could not open output file '" << outputfile << "'" << endl;
-        return 1;
-    }
+    string answer;
+    cout << "Compute CRC32C while copying? (y/n): " << endl;
+    getline(cin, answer);
+    bool withCrc = !answer.empty() && (answer[0] == 'y' || answer[0] == 'Y');
 
     cout << "Copying from '" << inputfile << "' to '" << outputfile << "'..." << endl;
 
-    // Step 3: Copy all text from source to destination.
-    string line;
-    // getline reads one full line at a time (without '\n').
-    // We write that line, then add '\n' so original line breaks are preserved.
-    while (getline(inputstream, line))
+    // Step 3: Copy the raw bytes from source to destination.
+    auto start = chrono::steady_clock::now();
+    CopyResult result = copyFile(inputfile, outputfile, withCrc);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (!result.ok)
     {
-        outputstream << line << '\n';
+        cout << "Error: copy failed (" << result.method << ")" << endl;
+        return 1;
     }
 
-    // Close write stream before reopening the same file for reading.
-    outputstream.close();
+    cout << "Copied " << result.bytes << " bytes using " << result.method << " in " << seconds << " s";
+    if (seconds > 0)
+        cout << " (" << (result.bytes / seconds / (1 << 20)) << " MB/s)";
+    cout << endl;
+    if (result.haveCrc)
+    {
+        cout << "CRC32C: " << hex << result.crc << dec << endl;
+    }
 
     // Step 4: Reopen destination file and display copied result.
+    // Only small files are echoed; large or binary copies would flood the terminal.
+    const long long maxDisplayBytes = 64 * 1024;
+    if (result.bytes > maxDisplayBytes)
+    {
+        return 0;
+    }
+
     ifstream print(outputfile);
     if (!print)
     {
@@ -56,6 +445,7 @@ int main()
     }
 
     cout << "Copied content:" << endl;
+    string line;
     while (getline(print, line))
     {
         cout << line << '\n';
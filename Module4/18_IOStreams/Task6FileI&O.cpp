@@ -2,24 +2,37 @@
 #include <vector>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <limits>
 #include <iomanip>
 #include <stdexcept>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
 using namespace std;
 
 // Book stores one record that will be persisted to a text file.
+// The strings are pmr::strings so a loaded catalog can place every title and
+// author in one arena instead of allocating per field; books built from user
+// input use the default heap resource as before.
 class Book
 {
 private:
-    string title;
-    string author;
+    pmr::string title;
+    pmr::string author;
     double price;
 
 public:
     Book() : title(""), author(""), price(0.0) {}
 
     Book(const string &title, const string &author, double price)
-        : title(title), author(author), price(price) {}
+        : title(title.data(), title.size()), author(author.data(), author.size()), price(price) {}
+
+    Book(string_view title, string_view author, double price, pmr::memory_resource *resource)
+        : title(title, resource), author(author, resource), price(price) {}
 
     void print() const
     {
@@ -32,6 +45,7 @@ public:
     // directly without exposing getters/setters only for persistence.
     friend void saveToFile(const Book &book, ofstream &ofs);
     friend Book loadFromFile(ifstream &ifs);
+    friend void saveCatalog(const vector<Book> &books, const string &fileName);
 };
 
 // Writes one complete book record in 3 lines:
@@ -72,12 +86,253 @@ Book loadFromFile(ifstream &ifs)
         return Book();
     }
 
-    double price;
+    double price = 0.0;
+    const char *last = priceText.data() + priceText.size();
+    if (from_chars(priceText.data(), last, price).ptr != last)
+    {
+        ifs.setstate(ios::failbit);
+        return Book();
+    }
     return Book(title, author, price);
 }
 
-int main()
+// ----- Binary catalog -----
+//
+// Layout (native little-endian):
+//   CatalogHeader
+//   double price[bookCount]                  fixed-width numeric column
+//   string table, per book: title then author, each as
+//     uint32 length + bytes (no terminator)
+// The whole file is read with a single read() and books are built straight
+// from the buffer: no getline, no text-to-number parsing, and all strings of
+// one catalog share a single arena allocation.
+
+const char CATALOG_MAGIC[4] = {'B', 'C', 'A', 'T'};
+const uint32_t CATALOG_VERSION = 1;
+const size_t CATALOG_WRITE_BUFFER = 1 << 20;
+
+struct CatalogHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t bookCount;
+    uint64_t stringTableBytes;
+};
+
+// Owns the books of a loaded catalog together with the arena their strings
+// live in. Books copied out of it allocate normally; books moved out keep
+// pointing into the arena and must not outlive the catalog.
+struct BookCatalog
+{
+    unique_ptr<pmr::monotonic_buffer_resource> arena;
+    vector<Book> books;
+};
+
+void saveCatalog(const vector<Book> &books, const string &fileName)
+{
+    ofstream ofs(fileName, ios::binary | ios::trunc);
+    if (!ofs)
+    {
+        throw runtime_error("could not open '" + fileName + "' for writing");
+    }
+
+    CatalogHeader header;
+    memcpy(header.magic, CATALOG_MAGIC, sizeof(header.magic));
+    header.version = CATALOG_VERSION;
+    header.bookCount = books.size();
+    header.stringTableBytes = 0;
+    for (const Book &book : books)
+    {
+        header.stringTableBytes += 2 * sizeof(uint32_t) + book.title.size() + book.author.size();
+    }
+    ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    vector<double> prices;
+    prices.reserve(books.size());
+    for (const Book &book : books)
+    {
+        prices.push_back(book.price);
+    }
+    ofs.write(reinterpret_cast<const char *>(prices.data()), prices.size() * sizeof(double));
+
+    // String table is staged in a fixed buffer and written a megabyte at a time
+    vector<char> buffer(CATALOG_WRITE_BUFFER);
+    size_t used = 0;
+    auto append = [&](const pmr::string &text)
+    {
+        uint32_t length = static_cast<uint32_t>(text.size());
+        if (used + sizeof(length) + length > buffer.size())
+        {
+            ofs.write(buffer.data(), used);
+            used = 0;
+            if (sizeof(length) + length > buffer.size())
+            {
+                buffer.resize(sizeof(length) + length);
+            }
+        }
+        memcpy(buffer.data() + used, &length, sizeof(length));
+        memcpy(buffer.data() + used + sizeof(length), text.data(), length);
+        used += sizeof(length) + length;
+    };
+    for (const Book &book : books)
+    {
+        append(book.title);
+        append(book.author);
+    }
+    ofs.write(buffer.data(), used);
+
+    if (!ofs.flush())
+    {
+        throw runtime_error("write to '" + fileName + "' failed");
+    }
+}
+
+BookCatalog loadCatalog(const string &fileName)
+{
+    ifstream ifs(fileName, ios::binary | ios::ate);
+    if (!ifs)
+    {
+        throw runtime_error("could not open '" + fileName + "' for reading");
+    }
+
+    // One read for the whole file
+    size_t size = static_cast<size_t>(ifs.tellg());
+    ifs.seekg(0);
+    unique_ptr<char[]> data(new char[size]);
+    if (!ifs.read(data.get(), size))
+    {
+        throw runtime_error("could not read '" + fileName + "'");
+    }
+
+    CatalogHeader header;
+    if (size < sizeof(header))
+    {
+        throw runtime_error("'" + fileName + "' is not a book catalog");
+    }
+    memcpy(&header, data.get(), sizeof(header));
+    if (memcmp(header.magic, CATALOG_MAGIC, sizeof(header.magic)) != 0)
+    {
+        throw runtime_error("'" + fileName + "' is not a book catalog");
+    }
+    if (header.version != CATALOG_VERSION)
+    {
+        throw runtime_error("unsupported catalog version " + to_string(header.version));
+    }
+    if (header.bookCount > (size - sizeof(header)) / sizeof(double) ||
+        header.stringTableBytes != size - sizeof(header) - header.bookCount * sizeof(double))
+    {
+        throw runtime_error("catalog '" + fileName + "' is truncated or corrupt");
+    }
+
+    const char *prices = data.get() + sizeof(header);
+    const char *cursor = prices + header.bookCount * sizeof(double);
+    const char *end = data.get() + size;
+
+    auto next = [&](string_view &text)
+    {
+        uint32_t length;
+        if (end - cursor < static_cast<ptrdiff_t>(sizeof(length)))
+        {
+            return false;
+        }
+        memcpy(&length, cursor, sizeof(length));
+        cursor += sizeof(length);
+        if (static_cast<size_t>(end - cursor) < length)
+        {
+            return false;
+        }
+        text = string_view(cursor, length);
+        cursor += length;
+        return true;
+    };
+
+    BookCatalog catalog;
+    // Room for every string plus its terminator, so the arena never grows
+    catalog.arena = make_unique<pmr::monotonic_buffer_resource>(
+        header.stringTableBytes + 2 * header.bookCount + 64);
+    catalog.books.reserve(header.bookCount);
+
+    for (uint64_t index = 0; index < header.bookCount; ++index)
+    {
+        string_view title, author;
+        if (!next(title) || !next(author))
+        {
+            throw runtime_error("catalog '" + fileName + "' is truncated or corrupt");
+        }
+        double price;
+        memcpy(&price, prices + index * sizeof(double), sizeof(price));
+        catalog.books.emplace_back(title, author, price, catalog.arena.get());
+    }
+
+    return catalog;
+}
+
+// Compares loading N generated books from the text format and the binary
+// catalog. Run as: ./a.out --bench [count]
+void runCatalogBenchmark(size_t count)
 {
+    vector<Book> books;
+    books.reserve(count);
+    for (size_t index = 0; index < count; ++index)
+    {
+        books.emplace_back("Book title number " + to_string(index),
+                           "Author " + to_string(index % 1000),
+                           5.0 + (index % 9000) / 100.0);
+    }
+
+    {
+        ofstream ofs("books_bench.txt");
+        for (const Book &book : books)
+        {
+            saveToFile(book, ofs);
+        }
+    }
+    saveCatalog(books, "books_bench.cat");
+
+    auto start = chrono::steady_clock::now();
+    size_t textLoaded = 0;
+    {
+        ifstream ifs("books_bench.txt");
+        vector<Book> loaded;
+        while (true)
+        {
+            Book book = loadFromFile(ifs);
+            if (!ifs)
+            {
+                break;
+            }
+            loaded.push_back(std::move(book));
+        }
+        textLoaded = loaded.size();
+    }
+    double textSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    size_t binaryLoaded = 0;
+    {
+        BookCatalog catalog = loadCatalog("books_bench.cat");
+        binaryLoaded = catalog.books.size();
+    }
+    double binarySeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << fixed << setprecision(3);
+    cout << "Text format   : " << textLoaded << " books in " << textSeconds << " s\n";
+    cout << "Binary catalog: " << binaryLoaded << " books in " << binarySeconds << " s\n";
+    if (binarySeconds > 0)
+    {
+        cout << "Speedup       : " << setprecision(1) << textSeconds / binarySeconds << "x\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && string(argv[1]) == "--bench")
+    {
+        size_t count = argc > 2 ? stoul(argv[2]) : 1000000;
+        runCatalogBenchmark(count);
+        return 0;
+    }
+
     // Step 1: Read number of books from user.
     int count;
     cout << "Enter number of books: ";
@@ -165,5 +420,20 @@ int main()
         cout << "-----------------------\n";
     }
 
+    // Step 5: Save the same books as a binary catalog and load them back.
+    const string catalogName = "books.cat";
+    try
+    {
+        saveCatalog(books, catalogName);
+        BookCatalog catalog = loadCatalog(catalogName);
+        cout << "\nBinary catalog '" << catalogName << "' round trip: "
+             << catalog.books.size() << " books loaded.\n";
+    }
+    catch (const exception &error)
+    {
+        cout << "Error: " << error.what() << '\n';
+        return 1;
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -1,9 +1,82 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <limits>
+#include <charconv>
+#include <thread>
+#include <vector>
+#include "LineReader.h"
 using namespace std;
 
+// Files above this size are summarized instead of echoed value by value
+const long long LARGE_FILE_BYTES = 64LL << 20;
+
+// Fast path for multi-GB inputs: lines come from LineReader as string_views,
+// tokens are split on whitespace and parsed with from_chars. No stream state
+// is involved, so each thread simply counts what it could not parse.
+int summarizeLargeFile(const string &inputfile)
+{
+    struct alignas(64) ChunkTotals
+    {
+        long long values = 0;
+        long long invalid = 0;
+        long long sum = 0;
+    };
+
+    unsigned threads = thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+    vector<ChunkTotals> totals(threads);
+
+    bool ok = forEachLineParallel(inputfile, threads, [&](unsigned chunk, string_view line)
+                                  {
+        ChunkTotals &t = totals[chunk];
+        size_t pos = 0;
+        while (true)
+        {
+            pos = line.find_first_not_of(" \t", pos);
+            if (pos == string_view::npos)
+                break;
+            size_t end = line.find_first_of(" \t", pos);
+            if (end == string_view::npos)
+                end = line.size();
+
+            int value = 0;
+            const char *first = line.data() + pos;
+            const char *last = line.data() + end;
+            if (from_chars(first, last, value).ptr == last)
+            {
+                t.values++;
+                t.sum += value;
+            }
+            else
+            {
+                t.invalid++;
+            }
+            pos = end;
+        } });
+
+    if (!ok)
+    {
+        cerr << "Error: unrecoverable read error.\n";
+        return 1;
+    }
+
+    ChunkTotals all;
+    for (const ChunkTotals &t : totals)
+    {
+        all.values += t.values;
+        all.invalid += t.invalid;
+        all.sum += t.sum;
+    }
+    cout << "Values read    : " << all.values << '\n'
+         << "Invalid tokens : " << all.invalid << '\n'
+         << "Sum of values  : " << all.sum << '\n';
+    cout << "Done reading file.\n";
+    return 0;
+}
+
 int main()
 {
     // Ask user for the input file that contains mixed tokens.
@@ -19,6 +92,14 @@ int main()
         return 1;
     }
 
+    ifs.seekg(0, ios::end);
+    long long size = ifs.tellg();
+    ifs.seekg(0, ios::beg);
+    if (size >= LARGE_FILE_BYTES)
+    {
+        return summarizeLargeFile(inputfile);
+    }
+
     int value;
     while (true)
     {
@@ -1,51 +1,1506 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
+#include <deque>
+#include <condition_variable>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
 using namespace std;
 
-class Logger
+extern char **environ;
+
+// Sync: format and write on the caller's thread (the original behaviour).
+// Async: callers only copy the message into a lock-free ring; a background
+// thread formats and writes whole batches.
+enum class LogMode
+{
+    Sync,
+    Async
+};
+
+// What an async log call does when the ring is full
+enum class OverflowPolicy
+{
+    Block, // wait for the writer to free a slot
+    Drop,  // discard the message silently
+    Count  // discard it, but report how many were lost in the log itself
+};
+
+// Severity of a message; each sink drops anything below its own minimum
+enum class LogLevel
+{
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+// When file data is forced to disk with fdatasync
+enum class FsyncPolicy
+{
+    Never,       // leave it to the OS (the original behaviour)
+    EveryMillis, // at most fsyncInterval ms after a write, even if the logger goes idle
+    EveryBytes   // once fsyncBytes have been written since the last sync
+};
+
+struct FileSinkOptions
+{
+    LogLevel minLevel = LogLevel::Debug;
+    size_t maxBytes = 0;             // rotate once the file reaches this size (0 = never)
+    chrono::seconds rotateEvery{0};  // rotate on this interval (0 = never)
+    size_t keepArchives = 5;         // rotated files kept on disk
+    bool compressArchives = true;    // gzip rotated files on a background thread
+    FsyncPolicy fsync = FsyncPolicy::Never;
+    chrono::milliseconds fsyncInterval{1000};
+    size_t fsyncBytes = 1 << 20;
+};
+
+// Digits after the seconds field in each timestamp
+enum class TimestampPrecision
+{
+    Seconds,      // [2026-01-31 12:00:00]
+    Milliseconds, // [2026-01-31 12:00:00.123]
+    Microseconds  // [2026-01-31 12:00:00.123456]
+};
+
+struct LoggerOptions
+{
+    LogMode mode = LogMode::Sync;
+    size_t queueCapacity = 1 << 16; // async ring slots
+    OverflowPolicy overflow = OverflowPolicy::Block;
+    TimestampPrecision precision = TimestampPrecision::Seconds;
+    FileSinkOptions file; // rotation and durability for the main log file
+};
+
+// Portable localtime: localtime_s is MSVC-only, localtime_r is POSIX
+static tm toLocalTime(time_t t)
+{
+    tm localTime{};
+#ifdef _WIN32
+    localtime_s(&localTime, &t);
+#else
+    localtime_r(&t, &localTime);
+#endif
+    return localTime;
+}
+
+// Wall-clock time derived from steady_clock. Reading the monotonic clock is
+// cheap (vDSO, no syscall) and never jumps backwards, so log lines stay in
+// order even if NTP steps the system clock while the process runs.
+class LogClock
+{
+    chrono::system_clock::time_point wallAnchor;
+    chrono::steady_clock::time_point steadyAnchor;
+
+public:
+    LogClock() : wallAnchor(chrono::system_clock::now()), steadyAnchor(chrono::steady_clock::now()) {}
+
+    chrono::system_clock::time_point now() const
+    {
+        return wallAnchor + chrono::duration_cast<chrono::system_clock::duration>(chrono::steady_clock::now() - steadyAnchor);
+    }
+};
+
+// Formats "[YYYY-MM-DD HH:MM:SS(.fraction)] ". The date part only changes
+// once a second, so it is rendered with localtime/strftime on a second change
+// and reused otherwise; the fraction is patched in with plain digit writes.
+// Not thread-safe: each formatting thread needs its own cache.
+class TimestampCache
+{
+    TimestampPrecision precision;
+    time_t cachedSecond = -1;
+    char cached[32]; // "[YYYY-MM-DD HH:MM:SS"
+    size_t cachedLength = 0;
+
+public:
+    static const size_t MAX_LENGTH = 32;
+
+    explicit TimestampCache(TimestampPrecision p = TimestampPrecision::Seconds) : precision(p) {}
+
+    // Writes the stamp into out (at least MAX_LENGTH bytes) and returns its length
+    size_t format(chrono::system_clock::time_point when, char *out)
+    {
+        auto sinceEpoch = chrono::duration_cast<chrono::microseconds>(when.time_since_epoch()).count();
+        time_t second = (time_t)(sinceEpoch / 1000000);
+        long micros = (long)(sinceEpoch % 1000000);
+        if (micros < 0)
+        {
+            second -= 1;
+            micros += 1000000;
+        }
+
+        if (second != cachedSecond)
+        {
+            tm localTime = toLocalTime(second);
+            cachedLength = strftime(cached, sizeof(cached), "[%Y-%m-%d %H:%M:%S", &localTime);
+            cachedSecond = second;
+        }
+
+        memcpy(out, cached, cachedLength);
+        char *p = out + cachedLength;
+
+        int digits = 0;
+        long fraction = 0;
+        if (precision == TimestampPrecision::Milliseconds)
+        {
+            digits = 3;
+            fraction = micros / 1000;
+        }
+        else if (precision == TimestampPrecision::Microseconds)
+        {
+            digits = 6;
+            fraction = micros;
+        }
+        if (digits > 0)
+        {
+            *p++ = '.';
+            for (int i = digits - 1; i >= 0; i--)
+            {
+                p[i] = (char)('0' + fraction % 10);
+                fraction /= 10;
+            }
+            p += digits;
+        }
+
+        *p++ = ']';
+        *p++ = ' ';
+        return (size_t)(p - out);
+    }
+};
+
+// Bounded multi-producer / single-consumer ring (Vyukov's sequence-numbered
+// queue). Each slot's sequence tells producers and the consumer whose turn it
+// is, so neither side takes a lock.
+class LogRing
 {
+public:
+    // Messages up to this size are stored inline; longer ones spill to a string
+    static const size_t INLINE_CAPACITY = 200;
+
+    struct Slot
+    {
+        atomic<size_t> sequence;
+        chrono::system_clock::time_point time;
+        LogLevel level;
+        size_t length;
+        char text[INLINE_CAPACITY];
+        string overflow;
+    };
+
 private:
-    ofstream logFile;
+    vector<Slot> slots;
+    size_t mask;
+    // Producer and consumer cursors on separate cache lines
+    alignas(64) atomic<size_t> enqueuePos{0};
+    alignas(64) size_t dequeuePos = 0;
+
+public:
+    explicit LogRing(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        slots = vector<Slot>(size);
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++)
+            slots[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    bool tryPush(chrono::system_clock::time_point time, LogLevel level, const string &message)
+    {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        Slot *slot;
+        while (true)
+        {
+            slot = &slots[pos & mask];
+            size_t seq = slot->sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+
+        slot->time = time;
+        slot->level = level;
+        slot->length = message.size();
+        if (message.size() <= INLINE_CAPACITY)
+            memcpy(slot->text, message.data(), message.size());
+        else
+            slot->overflow = message;
+        slot->sequence.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    // Consumer only: returns the next filled slot or nullptr if empty
+    Slot *front()
+    {
+        Slot *slot = &slots[dequeuePos & mask];
+        size_t seq = slot->sequence.load(memory_order_acquire);
+        return seq == dequeuePos + 1 ? slot : nullptr;
+    }
+
+    // Consumer only: hands the front slot back to producers
+    void pop()
+    {
+        Slot *slot = &slots[dequeuePos & mask];
+        if (slot->length > INLINE_CAPACITY)
+            string().swap(slot->overflow);
+        slot->sequence.store(dequeuePos + mask + 1, memory_order_release);
+        dequeuePos++;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Sinks
+//
+// The Logger formats each line once and fans it out to every sink whose
+// minimum level it passes. Sinks are only called with the logger's mutex
+// held, so they need no locking of their own (except MemoryRingSink, which is
+// also read from outside).
+// ---------------------------------------------------------------------------
+
+class LogSink
+{
+protected:
+    LogLevel minLevel;
 
 public:
-    explicit Logger(const string &fileName)
+    explicit LogSink(LogLevel level) : minLevel(level) {}
+    virtual ~LogSink() {}
+
+    bool accepts(LogLevel level) const { return level >= minLevel; }
+    virtual void write(LogLevel level, const char *line, size_t length) = 0;
+    // End of a batch (async) or of one call (sync): push buffered data out
+    virtual void flush() {}
+    // Called periodically even when idle, for time-based policies
+    virtual void tick(chrono::steady_clock::time_point) {}
+};
+
+class StderrSink : public LogSink
+{
+public:
+    explicit StderrSink(LogLevel level = LogLevel::Warning) : LogSink(level) {}
+
+    void write(LogLevel, const char *line, size_t length) override
     {
-        logFile.open(fileName, ios::app);
-        if (!logFile)
+        fwrite(line, 1, length, stderr);
+    }
+
+    void flush() override { fflush(stderr); }
+};
+
+// Keeps the last N lines in memory, e.g. to attach to a crash report
+class MemoryRingSink : public LogSink
+{
+    mutable mutex linesMutex;
+    deque<string> lines;
+    size_t capacity;
+
+public:
+    explicit MemoryRingSink(size_t maxLines, LogLevel level = LogLevel::Debug) : LogSink(level), capacity(maxLines) {}
+
+    void write(LogLevel, const char *line, size_t length) override
+    {
+        lock_guard<mutex> lock(linesMutex);
+        if (lines.size() == capacity)
+            lines.pop_front();
+        lines.emplace_back(line, length);
+    }
+
+    vector<string> snapshot() const
+    {
+        lock_guard<mutex> lock(linesMutex);
+        return vector<string>(lines.begin(), lines.end());
+    }
+};
+
+// Deletes all but the newest keep rotated copies of logName, i.e. files named
+// "<logName>.YYYYmmdd-HHMMSS[.N][.gz]". It scans the directory rather than
+// remembering what this process rotated, so archives left by earlier runs
+// count too. A file and its .gz (compression pending or failed) are one
+// archive.
+static void pruneArchives(const string &logName, size_t keep)
+{
+    size_t slash = logName.find_last_of('/');
+    string directory = slash == string::npos ? "" : logName.substr(0, slash + 1);
+    string prefix = logName.substr(directory.size()) + ".";
+
+    DIR *dir = opendir(directory.empty() ? "." : directory.c_str());
+    if (dir == nullptr)
+        return;
+
+    auto allDigits = [](const string &text, size_t from, size_t to)
+    {
+        for (size_t i = from; i < to; i++)
+        {
+            if (text[i] < '0' || text[i] > '9')
+                return false;
+        }
+        return from < to;
+    };
+
+    struct Archive
+    {
+        string stamp;
+        long sequence;
+        string path;
+    };
+    vector<Archive> found;
+    while (dirent *entry = readdir(dir))
+    {
+        string name = entry->d_name;
+        if (name.compare(0, prefix.size(), prefix) != 0)
+            continue;
+        string rest = name.substr(prefix.size());
+        if (rest.size() > 3 && rest.compare(rest.size() - 3, 3, ".gz") == 0)
+            rest.resize(rest.size() - 3);
+        if (rest.size() < 15 || rest[8] != '-' || !allDigits(rest, 0, 8) || !allDigits(rest, 9, 15))
+            continue;
+        long sequence = 0;
+        if (rest.size() > 15)
+        {
+            if (rest[15] != '.' || !allDigits(rest, 16, rest.size()) || rest.size() > 25)
+                continue;
+            sequence = stol(rest.substr(16));
+        }
+        found.push_back({rest.substr(0, 15), sequence, directory + name});
+    }
+    closedir(dir);
+
+    // Newest first: the stamp sorts chronologically, .N counts up within a second
+    sort(found.begin(), found.end(), [](const Archive &a, const Archive &b)
+         { return a.stamp != b.stamp ? a.stamp > b.stamp : a.sequence > b.sequence; });
+    size_t kept = 0;
+    for (size_t i = 0; i < found.size(); i++)
+    {
+        bool sameArchive = i > 0 && found[i].stamp == found[i - 1].stamp && found[i].sequence == found[i - 1].sequence;
+        if (!sameArchive)
+            kept++;
+        if (kept > keep)
+            remove(found[i].path.c_str());
+    }
+}
+
+// Compresses rotated files off the logging path. Uses the system gzip via
+// posix_spawn so the program needs no compression library; if gzip is
+// missing the archive simply stays uncompressed. Old archives are pruned
+// here, after each compression, so a .gz is never deleted while gzip is
+// still writing it.
+class ArchiveWorker
+{
+    string logName;
+    size_t keepArchives;
+    mutex queueMutex;
+    condition_variable ready;
+    deque<string> pending;
+    bool stopping = false;
+    thread worker;
+
+    void run()
+    {
+        while (true)
+        {
+            string path;
+            {
+                unique_lock<mutex> lock(queueMutex);
+                ready.wait(lock, [this]
+                           { return stopping || !pending.empty(); });
+                if (pending.empty())
+                    return;
+                path = pending.front();
+                pending.pop_front();
+            }
+
+            char gzip[] = "gzip", force[] = "-f";
+            char *argv[] = {gzip, force, &path[0], nullptr};
+            pid_t pid;
+            if (posix_spawnp(&pid, "gzip", nullptr, nullptr, argv, environ) == 0)
+            {
+                int status;
+                waitpid(pid, &status, 0);
+            }
+            pruneArchives(logName, keepArchives);
+        }
+    }
+
+public:
+    ArchiveWorker(const string &name, size_t keep) : logName(name), keepArchives(keep), worker(&ArchiveWorker::run, this) {}
+
+    // Finishes every queued compression before returning
+    ~ArchiveWorker()
+    {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        ready.notify_all();
+        worker.join();
+    }
+
+    void compress(const string &path)
+    {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            pending.push_back(path);
+        }
+        ready.notify_one();
+    }
+};
+
+// Appends to a file with size/time rotation and a configurable fsync policy
+class FileSink : public LogSink
+{
+    string fileName;
+    FileSinkOptions options;
+    int fd = -1;
+    string buffer;
+    size_t fileSize = 0;
+    size_t bytesSinceSync = 0;
+    chrono::steady_clock::time_point lastSync;
+    chrono::steady_clock::time_point nextRotation;
+    unique_ptr<ArchiveWorker> archiver;
+
+    void openFile()
+    {
+        fd = open(fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0)
         {
             throw runtime_error("Could not open log file: " + fileName);
         }
+        fileSize = (size_t)lseek(fd, 0, SEEK_END);
+        if (options.rotateEvery.count() > 0)
+            nextRotation = chrono::steady_clock::now() + options.rotateEvery;
+    }
+
+    void writeBuffer()
+    {
+        const char *p = buffer.data();
+        size_t left = buffer.size();
+        while (left > 0)
+        {
+            ssize_t n = ::write(fd, p, left);
+            if (n <= 0)
+                break; // disk full or closed; drop rather than stall the logger
+            p += n;
+            left -= (size_t)n;
+        }
+        fileSize += buffer.size() - left;
+        bytesSinceSync += buffer.size() - left;
+        buffer.clear();
+    }
+
+    void sync(chrono::steady_clock::time_point now)
+    {
+        fdatasync(fd);
+        bytesSinceSync = 0;
+        lastSync = now;
+    }
+
+    void rotate()
+    {
+        writeBuffer();
+        if (options.fsync != FsyncPolicy::Never)
+            fdatasync(fd);
+        close(fd);
+
+        // application.log -> application.log.20260131-120000[.N]
+        char stamp[32];
+        tm localTime = toLocalTime(time(nullptr));
+        strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &localTime);
+        string archive = fileName + "." + stamp;
+        for (int n = 1; access(archive.c_str(), F_OK) == 0 || access((archive + ".gz").c_str(), F_OK) == 0; n++)
+            archive = fileName + "." + stamp + "." + to_string(n);
+
+        if (rename(fileName.c_str(), archive.c_str()) == 0)
+        {
+            if (options.compressArchives)
+                archiver->compress(archive); // prunes once this one is compressed
+            else
+                pruneArchives(fileName, options.keepArchives);
+        }
+
+        openFile();
+    }
+
+    bool syncDue(chrono::steady_clock::time_point now) const
+    {
+        size_t unsynced = bytesSinceSync + buffer.size();
+        return unsynced > 0 &&
+               ((options.fsync == FsyncPolicy::EveryBytes && unsynced >= options.fsyncBytes) ||
+                (options.fsync == FsyncPolicy::EveryMillis && now - lastSync >= options.fsyncInterval));
+    }
+
+    bool rotationDue(chrono::steady_clock::time_point now) const
+    {
+        return (options.maxBytes > 0 && fileSize + buffer.size() >= options.maxBytes) ||
+               (options.rotateEvery.count() > 0 && now >= nextRotation);
+    }
+
+    // Buffered data only hits the file when a policy needs it there
+    void applyPolicies(chrono::steady_clock::time_point now)
+    {
+        bool needSync = syncDue(now);
+        bool needRotation = rotationDue(now);
+        if (!needSync && !needRotation)
+            return;
+
+        writeBuffer();
+        if (needSync)
+            sync(now);
+        if (needRotation)
+            rotate();
+    }
+
+public:
+    FileSink(const string &name, const FileSinkOptions &sinkOptions = FileSinkOptions())
+        : LogSink(sinkOptions.minLevel), fileName(name), options(sinkOptions), lastSync(chrono::steady_clock::now())
+    {
+        if (options.maxBytes > 0 || options.rotateEvery.count() > 0)
+        {
+            pruneArchives(fileName, options.keepArchives); // including earlier runs' archives
+            if (options.compressArchives)
+                archiver.reset(new ArchiveWorker(fileName, options.keepArchives));
+        }
+        openFile();
+    }
+
+    ~FileSink() override
+    {
+        writeBuffer();
+        if (options.fsync != FsyncPolicy::Never)
+            fdatasync(fd);
+        close(fd);
+    }
+
+    void write(LogLevel, const char *line, size_t length) override
+    {
+        buffer.append(line, length);
+        if (buffer.size() >= (1 << 16))
+            writeBuffer();
+    }
+
+    void flush() override
+    {
+        if (!buffer.empty())
+            writeBuffer();
+        applyPolicies(chrono::steady_clock::now());
+    }
+
+    void tick(chrono::steady_clock::time_point now) override
+    {
+        applyPolicies(now);
+    }
+};
+
+class Logger
+{
+private:
+    vector<unique_ptr<LogSink>> sinks;
+    mutex fileMutex; // serialises sync-mode writers and sink changes
+    string line;     // reusable line buffer, guarded by fileMutex
+
+    LogMode mode;
+    OverflowPolicy policy;
+    LogClock clock;
+    TimestampCache stampCache; // used under fileMutex (sync) or by the writer thread (async)
+    unique_ptr<LogRing> ring;
+    thread writer;
+    thread ticker; // sync mode: applies time-based sink policies while no one logs
+    mutex tickerMutex;
+    condition_variable tickerWake;
+    atomic<bool> stopping{false};
+    atomic<size_t> dropped{0};
+
+    // Formats one line and hands it to every sink that wants this level.
+    // Caller holds fileMutex.
+    void dispatch(chrono::system_clock::time_point when, LogLevel level, const char *text, size_t length)
+    {
+        char stamp[TimestampCache::MAX_LENGTH];
+        line.assign(stamp, stampCache.format(when, stamp));
+        line.append(text, length);
+        line.push_back('\n');
+        for (unique_ptr<LogSink> &sink : sinks)
+        {
+            if (sink->accepts(level))
+                sink->write(level, line.data(), line.size());
+        }
+    }
+
+    // Background thread: drain everything available into the sinks, flush
+    // them once per batch, back off briefly when idle. Exits only after a
+    // final drain on shutdown.
+    void writerLoop()
+    {
+        const size_t maxBatch = 4096;
+        size_t reportedDrops = 0;
+
+        while (true)
+        {
+            bool stopRequested = stopping.load(memory_order_acquire);
+            size_t drained = 0;
+
+            {
+                lock_guard<mutex> lock(fileMutex);
+                while (drained < maxBatch)
+                {
+                    LogRing::Slot *slot = ring->front();
+                    if (slot == nullptr)
+                        break;
+                    const char *text = slot->length <= LogRing::INLINE_CAPACITY ? slot->text : slot->overflow.data();
+                    dispatch(slot->time, slot->level, text, slot->length);
+                    ring->pop();
+                    drained++;
+                }
+
+                if (policy == OverflowPolicy::Count)
+                {
+                    size_t total = dropped.load(memory_order_relaxed);
+                    if (total != reportedDrops)
+                    {
+                        string note = "Logger dropped " + to_string(total - reportedDrops) + " message(s): queue full";
+                        dispatch(clock.now(), LogLevel::Warning, note.data(), note.size());
+                        reportedDrops = total;
+                        drained++;
+                    }
+                }
+
+                auto now = chrono::steady_clock::now();
+                for (unique_ptr<LogSink> &sink : sinks)
+                {
+                    if (drained > 0)
+                        sink->flush();
+                    else
+                        sink->tick(now);
+                }
+            }
+
+            if (drained == 0)
+            {
+                if (stopRequested)
+                    return; // nothing left and no more producers
+                this_thread::sleep_for(chrono::microseconds(200));
+            }
+        }
+    }
+
+    // Sync mode only ticks sinks from log(), so without this an idle logger
+    // would never fsync its last lines or rotate on schedule
+    void tickerLoop(chrono::milliseconds interval)
+    {
+        unique_lock<mutex> wait(tickerMutex);
+        while (!tickerWake.wait_for(wait, interval, [this]
+                                    { return stopping.load(memory_order_acquire); }))
+        {
+            lock_guard<mutex> lock(fileMutex);
+            auto now = chrono::steady_clock::now();
+            for (unique_ptr<LogSink> &sink : sinks)
+                sink->tick(now);
+        }
+    }
+
+public:
+    explicit Logger(const string &fileName, const LoggerOptions &options = LoggerOptions())
+        : mode(options.mode), policy(options.overflow), stampCache(options.precision)
+    {
+        sinks.emplace_back(new FileSink(fileName, options.file));
+
+        if (mode == LogMode::Async)
+        {
+            ring.reset(new LogRing(options.queueCapacity));
+            writer = thread(&Logger::writerLoop, this);
+        }
+        else if (options.file.fsync == FsyncPolicy::EveryMillis || options.file.rotateEvery.count() > 0)
+        {
+            chrono::milliseconds interval(1000);
+            if (options.file.fsync == FsyncPolicy::EveryMillis)
+                interval = min(interval, options.file.fsyncInterval);
+            ticker = thread(&Logger::tickerLoop, this, max(interval, chrono::milliseconds(1)));
+        }
+    }
+
+    // Async mode: every message accepted before destruction reaches the file
+    ~Logger()
+    {
+        if (writer.joinable())
+        {
+            stopping.store(true, memory_order_release);
+            writer.join();
+        }
+        if (ticker.joinable())
+        {
+            {
+                lock_guard<mutex> lock(tickerMutex);
+                stopping.store(true, memory_order_release);
+            }
+            tickerWake.notify_all();
+            ticker.join();
+        }
+        // Sinks (and their file buffers) are flushed by their destructors
+    }
+
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
+    // Adds another destination, e.g. StderrSink or MemoryRingSink
+    void addSink(unique_ptr<LogSink> sink)
+    {
+        lock_guard<mutex> lock(fileMutex);
+        sinks.push_back(move(sink));
     }
 
     void log(const string &message)
     {
-        auto now = chrono::system_clock::now();
-        time_t currentTime = chrono::system_clock::to_time_t(now);
+        log(LogLevel::Info, message);
+    }
+
+    void log(LogLevel level, const string &message)
+    {
+        auto now = clock.now();
+
+        if (mode == LogMode::Async)
+        {
+            while (!ring->tryPush(now, level, message))
+            {
+                if (policy != OverflowPolicy::Block)
+                {
+                    dropped.fetch_add(1, memory_order_relaxed);
+                    return;
+                }
+                this_thread::yield();
+            }
+            return;
+        }
+
+        lock_guard<mutex> lock(fileMutex);
+        dispatch(now, level, message.data(), message.size());
+        // Sync mode stays buffered like the old ofstream; sinks write out when
+        // their buffer fills, and fsync/rotation policies are checked here
+        auto steadyNow = chrono::steady_clock::now();
+        for (unique_ptr<LogSink> &sink : sinks)
+            sink->tick(steadyNow);
+    }
+
+    size_t droppedCount() const { return dropped.load(memory_order_relaxed); }
+};
+
+// ---------------------------------------------------------------------------
+// Binary structured logging
+//
+// log("Order %d took %.2f ms", id, ms) stores a format-string ID, a timestamp
+// and the raw argument bytes; no text is produced on the hot path. The file
+// is self-describing: the first use of each format string writes a definition
+// record, so decodeBinaryLog() can render it later without the program.
+//
+// Integers are LEB128 varints (signed ones zigzag-encoded first) and each
+// timestamp is stored as the zigzag delta from the previous record, so small
+// numbers and closely spaced messages cost one or two bytes each.
+//
+// File layout:  "BLOG" u32 version, then records
+//   'F' varint id, u16 fmtLength, fmt bytes, u8 argCount, argCount type codes
+//   'M' varint id, zigzag varint nanosecond delta, arguments
+// Argument encoding by type code:
+//   'i' zigzag varint   'u' varint   'd' 8-byte double   'c' char
+//   's' u16 length + bytes
+// ---------------------------------------------------------------------------
+
+const uint32_t BINARY_LOG_VERSION = 1;
+const size_t MAX_VARINT_BYTES = 10;
+
+static char *writeVarint(char *p, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        *p++ = (char)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (char)value;
+    return p;
+}
+
+// Returns false if the varint runs past end (a truncated file)
+static bool readVarint(const char *&p, const char *end, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (p >= end)
+            return false;
+        unsigned char byte = (unsigned char)*p++;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return true;
+}
 
-        tm localTime{};
-        localtime_s(&localTime, &currentTime);
+static uint64_t zigzagEncode(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static int64_t zigzagDecode(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
 
-        logFile << '[' << put_time(&localTime, "%Y-%m-%d %H:%M:%S") << "] "
-                << message << '\n';
+// size() is an upper bound used to reserve buffer space; encode() returns
+// the real end
+template <typename T>
+struct BinaryArg
+{
+    static_assert(is_arithmetic<T>::value, "BinaryLogger supports numbers, chars and strings");
+    static const char code = is_floating_point<T>::value ? 'd' : (is_signed<T>::value ? 'i' : 'u');
+    static size_t size(T) { return is_floating_point<T>::value ? 8 : MAX_VARINT_BYTES; }
+    static char *encode(char *p, T value)
+    {
+        if (is_floating_point<T>::value)
+        {
+            double d = (double)value;
+            memcpy(p, &d, 8);
+            return p + 8;
+        }
+        if (is_signed<T>::value)
+            return writeVarint(p, zigzagEncode((int64_t)value));
+        return writeVarint(p, (uint64_t)value);
+    }
+};
+
+template <>
+struct BinaryArg<char>
+{
+    static const char code = 'c';
+    static size_t size(char) { return 1; }
+    static char *encode(char *p, char value)
+    {
+        *p = value;
+        return p + 1;
+    }
+};
+
+template <>
+struct BinaryArg<bool>
+{
+    static const char code = 'u';
+    static size_t size(bool) { return 1; }
+    static char *encode(char *p, bool value) { return BinaryArg<uint64_t>::encode(p, value ? 1 : 0); }
+};
+
+struct BinaryStringArg
+{
+    static const char code = 's';
+    static size_t clampedLength(size_t n) { return n > 0xFFFF ? 0xFFFF : n; }
+    static char *encode(char *p, const char *text, size_t n)
+    {
+        uint16_t length = (uint16_t)clampedLength(n);
+        memcpy(p, &length, 2);
+        memcpy(p + 2, text, length);
+        return p + 2 + length;
+    }
+};
+
+template <>
+struct BinaryArg<string>
+{
+    static const char code = 's';
+    static size_t size(const string &s) { return 2 + BinaryStringArg::clampedLength(s.size()); }
+    static char *encode(char *p, const string &s) { return BinaryStringArg::encode(p, s.data(), s.size()); }
+};
+
+template <>
+struct BinaryArg<const char *>
+{
+    static const char code = 's';
+    static size_t size(const char *s) { return 2 + BinaryStringArg::clampedLength(strlen(s)); }
+    static char *encode(char *p, const char *s) { return BinaryStringArg::encode(p, s, strlen(s)); }
+};
+
+template <>
+struct BinaryArg<char *> : BinaryArg<const char *>
+{
+};
+
+// Arrays decay to pointers so string literals pick the const char * encoder
+template <typename T>
+using BinaryArgFor = BinaryArg<typename decay<T>::type>;
+
+class BinaryLogger
+{
+    FILE *file;
+    vector<char> buffer;
+    size_t used = 0;
+    mutex bufferMutex;
+    LogClock clock;
+    // A format is identified by the literal's address plus the argument type
+    // codes of the log() instantiation: the same literal logged with other
+    // argument types is encoded differently, so it needs its own definition.
+    // codes points at a static array per instantiation, so comparing
+    // addresses is enough.
+    struct FormatKey
+    {
+        const char *fmt;
+        const char *codes;
+        bool operator==(const FormatKey &other) const { return fmt == other.fmt && codes == other.codes; }
+    };
+    struct FormatKeyHash
+    {
+        size_t operator()(const FormatKey &key) const
+        {
+            return hash<const char *>()(key.fmt) * 31 + hash<const char *>()(key.codes);
+        }
+    };
+    unordered_map<FormatKey, uint32_t, FormatKeyHash> formatIds;
+    uint32_t nextId = 0;
+    uint64_t lastNanos = 0;
+
+    // Returns room for at most n bytes; commit() records how many were used
+    char *reserve(size_t n)
+    {
+        if (used + n > buffer.size())
+        {
+            flushLocked();
+            if (n > buffer.size())
+                buffer.resize(n);
+        }
+        return buffer.data() + used;
+    }
+
+    void commit(const char *end) { used = (size_t)(end - buffer.data()); }
+
+    void flushLocked()
+    {
+        if (used > 0)
+        {
+            fwrite(buffer.data(), 1, used, file);
+            used = 0;
+        }
+    }
+
+    template <typename... Args>
+    uint32_t formatId(const char *fmt)
+    {
+        static const char codes[] = {BinaryArgFor<Args>::code..., '\0'};
+        FormatKey key{fmt, codes};
+        auto it = formatIds.find(key);
+        if (it != formatIds.end())
+            return it->second;
+
+        uint32_t id = nextId++;
+        formatIds.emplace(key, id);
+
+        uint16_t fmtLength = (uint16_t)min<size_t>(strlen(fmt), 0xFFFF);
+        uint8_t argCount = (uint8_t)sizeof...(Args);
+        char *p = reserve(1 + MAX_VARINT_BYTES + 2 + fmtLength + 1 + argCount);
+        *p++ = 'F';
+        p = writeVarint(p, id);
+        memcpy(p, &fmtLength, 2);
+        memcpy(p + 2, fmt, fmtLength);
+        p += 2 + fmtLength;
+        *p++ = (char)argCount;
+        memcpy(p, codes, argCount);
+        commit(p + argCount);
+        return id;
+    }
+
+public:
+    explicit BinaryLogger(const string &fileName, size_t bufferSize = 1 << 16) : buffer(bufferSize)
+    {
+        file = fopen(fileName.c_str(), "wb");
+        if (file == NULL)
+        {
+            throw runtime_error("Could not open binary log file: " + fileName);
+        }
+        fwrite("BLOG", 1, 4, file);
+        fwrite(&BINARY_LOG_VERSION, sizeof(BINARY_LOG_VERSION), 1, file);
+    }
+
+    ~BinaryLogger()
+    {
+        flush();
+        fclose(file);
+    }
+
+    BinaryLogger(const BinaryLogger &) = delete;
+    BinaryLogger &operator=(const BinaryLogger &) = delete;
+
+    // fmt must be a string literal (or otherwise outlive the logger): its
+    // address, together with the argument types, identifies the format.
+    // Arguments follow printf conventions.
+    template <typename... Args>
+    void log(const char *fmt, const Args &...args)
+    {
+        uint64_t nanos = (uint64_t)chrono::duration_cast<chrono::nanoseconds>(clock.now().time_since_epoch()).count();
+        size_t payload = 0;
+        (void)initializer_list<int>{(payload += BinaryArgFor<Args>::size(args), 0)...};
+
+        lock_guard<mutex> lock(bufferMutex);
+        uint32_t id = formatId<Args...>(fmt);
+        char *p = reserve(1 + 2 * MAX_VARINT_BYTES + payload);
+        *p++ = 'M';
+        p = writeVarint(p, id);
+        p = writeVarint(p, zigzagEncode((int64_t)(nanos - lastNanos)));
+        lastNanos = nanos;
+        (void)initializer_list<int>{(p = BinaryArgFor<Args>::encode(p, args), 0)...};
+        commit(p);
+    }
+
+    void flush()
+    {
+        lock_guard<mutex> lock(bufferMutex);
+        flushLocked();
+        fflush(file);
     }
 };
 
-int main()
+// The decoder hands specs from the file to snprintf, so only a strict subset
+// is accepted: %[-+ #0]*[0-9]*(.[0-9]*)?[hljztL]* and one of the conversions
+// below. '*' (reads an argument that was never passed) and 'n' (writes
+// through a pointer) never qualify. Returns the index of the conversion
+// character, or npos if fmt[percent] does not start such a spec.
+static size_t conversionSpecEnd(const string &fmt, size_t percent)
 {
+    auto isAny = [](char ch, const char *set)
+    { return ch != '\0' && strchr(set, ch) != NULL; };
+    auto isDigit = [](char ch)
+    { return ch >= '0' && ch <= '9'; };
+
+    size_t j = percent + 1;
+    while (j < fmt.size() && isAny(fmt[j], "-+ #0"))
+        j++;
+    for (int digits = 0; j < fmt.size() && isDigit(fmt[j]) && digits < 3; digits++)
+        j++;
+    if (j < fmt.size() && fmt[j] == '.')
+    {
+        j++;
+        for (int digits = 0; j < fmt.size() && isDigit(fmt[j]) && digits < 3; digits++)
+            j++;
+    }
+    while (j < fmt.size() && isAny(fmt[j], "hljztL"))
+        j++;
+    if (j < fmt.size() && isAny(fmt[j], "diouxXeEfFgGaAcsp"))
+        return j;
+    return string::npos;
+}
+
+// Formats one conversion spec (e.g. "%08.3f") with a decoded argument.
+// Length modifiers in the original spec are ignored because arguments were
+// widened to 64 bits when they were logged. Returns false if the argument
+// runs past end.
+static bool renderArgument(string &out, const string &spec, char code, const char *&p, const char *end)
+{
+    string clean;
+    for (char ch : spec)
+    {
+        if (strchr("hljztL", ch) == NULL)
+            clean.push_back(ch);
+    }
+    char conversion = clean.back();
+    clean.pop_back();
+
+    char text[512];
+    if (code == 's')
+    {
+        uint16_t length;
+        if (end - p < 2)
+            return false;
+        memcpy(&length, p, 2);
+        if (end - p - 2 < length)
+            return false;
+        string value(p + 2, length);
+        p += 2 + length;
+        snprintf(text, sizeof(text), (clean + "s").c_str(), value.c_str());
+    }
+    else if (code == 'c')
+    {
+        if (p >= end)
+            return false;
+        snprintf(text, sizeof(text), (clean + "c").c_str(), *p);
+        p += 1;
+    }
+    else if (code == 'd')
+    {
+        double value;
+        if (end - p < 8)
+            return false;
+        memcpy(&value, p, 8);
+        p += 8;
+        bool floating = strchr("fFeEgGaA", conversion) != NULL;
+        if (floating)
+            snprintf(text, sizeof(text), (clean + conversion).c_str(), value);
+        else
+            snprintf(text, sizeof(text), (clean + "lld").c_str(), (long long)value);
+    }
+    else
+    {
+        uint64_t bits;
+        if (!readVarint(p, end, bits))
+            return false;
+        if (code == 'i')
+            bits = (uint64_t)zigzagDecode(bits);
+        if (strchr("fFeEgGaA", conversion) != NULL)
+            snprintf(text, sizeof(text), (clean + conversion).c_str(), code == 'i' ? (double)(int64_t)bits : (double)bits);
+        else if (conversion == 's' || conversion == 'c')
+            snprintf(text, sizeof(text), "%lld", (long long)bits);
+        else if (conversion == 'p')
+            snprintf(text, sizeof(text), "0x%llx", (unsigned long long)bits);
+        else
+            snprintf(text, sizeof(text), (clean + "ll" + conversion).c_str(), bits);
+    }
+    out += text;
+    return true;
+}
+
+// Offline decoder: renders a binary log as "[timestamp] message" lines.
+// Run with: ./Task9Logging --decode app.blog [output.log]
+bool decodeBinaryLog(const string &inputName, ostream &out)
+{
+    ifstream in(inputName, ios::binary);
+    if (!in)
+    {
+        cerr << "Could not open " << inputName << '\n';
+        return false;
+    }
+    vector<char> data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+    uint32_t version = 0;
+    if (data.size() < 8 || memcmp(data.data(), "BLOG", 4) != 0 ||
+        (memcpy(&version, data.data() + 4, 4), version != BINARY_LOG_VERSION))
+    {
+        cerr << inputName << " is not a binary log (version " << BINARY_LOG_VERSION << ")\n";
+        return false;
+    }
+
+    struct Definition
+    {
+        string fmt;
+        string codes;
+    };
+    unordered_map<uint32_t, Definition> definitions;
+    TimestampCache stamps(TimestampPrecision::Microseconds);
+    const char *p = data.data() + 8;
+    const char *end = data.data() + data.size();
+    string line;
+    uint64_t nanos = 0;
+
+    // A log cut short by a crash ends in a partial record: everything before
+    // it has been written to out when this is reported
+    auto truncated = [&](const char *record)
+    {
+        cerr << inputName << ": truncated record at offset " << (record - data.data()) << '\n';
+        return false;
+    };
+
+    while (p < end)
+    {
+        const char *record = p;
+        char kind = *p++;
+        uint64_t id;
+        if (!readVarint(p, end, id))
+            return truncated(record);
+
+        if (kind == 'F')
+        {
+            uint16_t fmtLength;
+            if (end - p < 2)
+                return truncated(record);
+            memcpy(&fmtLength, p, 2);
+            if (end - p - 2 < (ptrdiff_t)fmtLength + 1)
+                return truncated(record);
+            Definition definition;
+            definition.fmt.assign(p + 2, fmtLength);
+            p += 2 + fmtLength;
+            uint8_t argCount = (uint8_t)*p++;
+            if (end - p < argCount)
+                return truncated(record);
+            definition.codes.assign(p, argCount);
+            p += argCount;
+            definitions[(uint32_t)id] = definition;
+            continue;
+        }
+
+        if (kind != 'M' || definitions.count((uint32_t)id) == 0)
+        {
+            cerr << "Corrupt record in " << inputName << " at offset " << (record - data.data()) << '\n';
+            return false;
+        }
+
+        uint64_t delta;
+        if (!readVarint(p, end, delta))
+            return truncated(record);
+        nanos += (uint64_t)zigzagDecode(delta);
+        chrono::system_clock::time_point when{chrono::duration_cast<chrono::system_clock::duration>(chrono::nanoseconds(nanos))};
+
+        const Definition &definition = definitions[(uint32_t)id];
+        char stamp[TimestampCache::MAX_LENGTH];
+        line.assign(stamp, stamps.format(when, stamp));
+
+        size_t nextArg = 0;
+        const string &fmt = definition.fmt;
+        for (size_t i = 0; i < fmt.size(); i++)
+        {
+            if (fmt[i] != '%')
+            {
+                line.push_back(fmt[i]);
+                continue;
+            }
+            if (i + 1 < fmt.size() && fmt[i + 1] == '%')
+            {
+                line.push_back('%');
+                i++;
+                continue;
+            }
+            size_t j = conversionSpecEnd(fmt, i);
+            if (j == string::npos)
+            {
+                line.push_back('%'); // not a conversion we render: keep the text as written
+                continue;
+            }
+            if (nextArg >= definition.codes.size())
+            {
+                line.append(fmt, i, j - i + 1);
+                i = j;
+                continue;
+            }
+            if (!renderArgument(line, fmt.substr(i, j - i + 1), definition.codes[nextArg++], p, end))
+                return truncated(record);
+            i = j;
+        }
+        // Arguments without a matching specifier are still consumed
+        while (nextArg < definition.codes.size())
+        {
+            string ignored;
+            if (!renderArgument(ignored, "%s", definition.codes[nextArg++], p, end))
+                return truncated(record);
+        }
+
+        line.push_back('\n');
+        out << line;
+    }
+
+    return true;
+}
+
+// Throughput and caller-side latency of sync vs async logging.
+// Run with: ./Task9Logging --bench
+void runBenchmark()
+{
+    const int messagesPerThread = 200000;
+    const int threadCounts[] = {1, 4};
+    const string message = "Order 123456 processed for customer 42 in 17 ms";
+
+    cout << left << setw(8) << "Mode" << setw(10) << "Threads" << setw(16) << "Msgs/sec"
+         << setw(12) << "p50 ns" << setw(12) << "p99 ns" << setw(12) << "p99.9 ns" << '\n';
+
+    for (LogMode mode : {LogMode::Sync, LogMode::Async})
+    {
+        for (int threads : threadCounts)
+        {
+            const string fileName = mode == LogMode::Sync ? "bench_sync.log" : "bench_async.log";
+            ofstream(fileName, ios::trunc).close();
+
+            vector<vector<long long>> latencies(threads);
+            chrono::steady_clock::time_point start, end;
+            {
+                LoggerOptions options;
+                options.mode = mode;
+                Logger logger(fileName, options);
+                vector<thread> workers;
+                start = chrono::steady_clock::now();
+                for (int t = 0; t < threads; t++)
+                {
+                    workers.emplace_back([&, t]()
+                                         {
+                        vector<long long> &samples = latencies[t];
+                        samples.reserve(messagesPerThread);
+                        for (int i = 0; i < messagesPerThread; i++)
+                        {
+                            auto before = chrono::steady_clock::now();
+                            logger.log(message);
+                            samples.push_back((chrono::steady_clock::now() - before).count());
+                        } });
+                }
+                for (thread &w : workers)
+                    w.join();
+                end = chrono::steady_clock::now(); // producer-side time
+            }                                      // destructor drains the async queue
+
+            vector<long long> all;
+            for (vector<long long> &samples : latencies)
+                all.insert(all.end(), samples.begin(), samples.end());
+            sort(all.begin(), all.end());
+
+            double seconds = chrono::duration<double>(end - start).count();
+            auto percentile = [&](double p)
+            { return all[min(all.size() - 1, (size_t)(p * all.size()))]; };
+
+            cout << left << setw(8) << (mode == LogMode::Sync ? "sync" : "async") << setw(10) << threads
+                 << setw(16) << fixed << setprecision(0) << (all.size() / seconds)
+                 << setw(12) << percentile(0.50) << setw(12) << percentile(0.99)
+                 << setw(12) << percentile(0.999) << '\n';
+        }
+    }
+}
+
+// Per-line timestamp cost: cached formatter vs localtime + strftime every call
+void runTimestampBenchmark()
+{
+    const int iterations = 5000000;
+    LogClock clock;
+    TimestampCache cache(TimestampPrecision::Microseconds);
+    char out[TimestampCache::MAX_LENGTH];
+    size_t checksum = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        checksum += cache.format(clock.now(), out);
+    double cachedNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        time_t t = chrono::system_clock::to_time_t(chrono::system_clock::now());
+        tm localTime = toLocalTime(t);
+        checksum += strftime(out, sizeof(out), "[%Y-%m-%d %H:%M:%S] ", &localTime);
+    }
+    double uncachedNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    cout << "\nTimestamp formatting (ns/line, incl. clock read):\n"
+         << "  cached  : " << fixed << setprecision(1) << cachedNs << '\n'
+         << "  strftime: " << uncachedNs << '\n'
+         << "  (checksum " << checksum << ")\n";
+}
+
+// Text logger with string building vs binary logger with deferred formatting
+void runBinaryBenchmark()
+{
+    const int iterations = 1000000;
+
+    auto start = chrono::steady_clock::now();
+    {
+        Logger logger("bench_text.log");
+        for (int i = 0; i < iterations; i++)
+        {
+            logger.log("Order " + to_string(i) + " processed for customer " + to_string(i % 977) +
+                       " in " + to_string(i % 50) + " ms");
+        }
+    }
+    double textNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    start = chrono::steady_clock::now();
+    {
+        BinaryLogger logger("bench_binary.blog");
+        for (int i = 0; i < iterations; i++)
+        {
+            logger.log("Order %d processed for customer %d in %d ms", i, i % 977, i % 50);
+        }
+    }
+    double binaryNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    ifstream textFile("bench_text.log", ios::binary | ios::ate);
+    ifstream binaryFile("bench_binary.blog", ios::binary | ios::ate);
+    double textBytes = (double)textFile.tellg();
+    double binaryBytes = (double)binaryFile.tellg();
+
+    cout << "\nStructured logging (" << iterations << " messages):\n"
+         << "  text + to_string: " << fixed << setprecision(1) << textNs << " ns/msg, "
+         << textBytes / (1 << 20) << " MB\n"
+         << "  binary          : " << binaryNs << " ns/msg, " << binaryBytes / (1 << 20) << " MB ("
+         << textBytes / binaryBytes << "x smaller)\n";
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && string(argv[1]) == "--bench")
+    {
+        runBenchmark();
+        runTimestampBenchmark();
+        runBinaryBenchmark();
+        return 0;
+    }
+
+    if (argc > 2 && string(argv[1]) == "--decode")
+    {
+        if (argc > 3)
+        {
+            ofstream out(argv[3]);
+            return decodeBinaryLog(argv[2], out) ? 0 : 1;
+        }
+        return decodeBinaryLog(argv[2], cout) ? 0 : 1;
+    }
+
     const string logFileName = "application.log";
 
     try
     {
-        Logger logger(logFileName);
+        {
+            Logger logger(logFileName);
+
+            logger.log("Application started");
+            logger.log("Loading configuration");
+            logger.log("Application finished successfully");
+        }
 
-        logger.log("Application started");
-        logger.log("Loading configuration");
-        logger.log("Application finished successfully");
+        {
+            // Async mode: same API, writes happen on a background thread and
+            // are flushed before the destructor returns
+            LoggerOptions options;
+            options.mode = LogMode::Async;
+            options.precision = TimestampPrecision::Milliseconds;
+            Logger asyncLogger(logFileName, options);
+            asyncLogger.log("Async logger started");
+            asyncLogger.log("Async logger finished");
+        }
+
+        {
+            // Rotation, durability and fan-out: the file rotates every 4 KB
+            // (archives gzipped in the background), is fsynced every 100 ms,
+            // warnings also go to stderr and the last 100 lines stay in memory
+            LoggerOptions options;
+            options.file.maxBytes = 4096;
+            options.file.keepArchives = 3;
+            options.file.fsync = FsyncPolicy::EveryMillis;
+            options.file.fsyncInterval = chrono::milliseconds(100);
+            Logger rotatingLogger("rotating.log", options);
+
+            MemoryRingSink *recent = new MemoryRingSink(100);
+            rotatingLogger.addSink(unique_ptr<LogSink>(recent));
+            rotatingLogger.addSink(unique_ptr<LogSink>(new StderrSink(LogLevel::Warning)));
+
+            for (int i = 0; i < 200; i++)
+            {
+                rotatingLogger.log(LogLevel::Debug, "Processing item " + to_string(i));
+            }
+            rotatingLogger.log(LogLevel::Warning, "Disk usage above 80%");
+            cout << "In-memory sink holds " << recent->snapshot().size() << " recent lines.\n";
+        }
+
+        {
+            // Structured mode: arguments are stored raw and rendered later
+            // with ./Task9Logging --decode application.blog
+            BinaryLogger binaryLogger("application.blog");
+            binaryLogger.log("Loaded %d settings from %s in %.3f ms", 42, "config.ini", 1.25);
+            binaryLogger.log("Cache hit ratio %u%%", 97u);
+        }
 
         cout << "Logs written to '" << logFileName << "'.\n";
     }
@@ -0,0 +1,346 @@
+// ConcurrentQueue.h - Bounded lock-free queues for passing work between threads
+//
+// MPMCQueue<T>  any number of producers and consumers. Dmitry Vyukov's
+//               bounded queue: a power-of-two ring where every cell carries a
+//               sequence number telling whose turn it is. A push or pop is one
+//               CAS on a shared position plus one store to the cell, with no
+//               lock and no allocation after construction.
+// SPSCQueue<T>  exactly one producer thread and one consumer thread. Needs no
+//               CAS at all: each side owns one index and keeps a cached copy of
+//               the other side's index, so it only touches the other side's
+//               cache line when the cached value says the queue is full/empty.
+//
+// The hot indices sit on separate cache lines so producers and consumers do
+// not invalidate each other's lines (false sharing).
+//
+// Usage:
+//   MPMCQueue<Job> jobs(1024);           // capacity is rounded up to a power of two
+//   jobs.push(job);                      // spins (then yields) while full
+//   if (jobs.tryPop(job)) { ... }        // false if empty
+//
+//   Job batch[32];
+//   size_t n = jobs.tryPopBatch(batch, 32);   // up to 32 items, one CAS
+//
+// Batch operations claim several consecutive cells with a single CAS (MPMC)
+// or publish them with a single store (SPSC), which amortizes the shared
+// cache-line traffic when items are small.
+
+#ifndef CONCURRENT_QUEUE_H
+#define CONCURRENT_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+constexpr size_t QUEUE_CACHE_LINE = 64;
+
+inline size_t roundUpToPowerOfTwo(size_t n)
+{
+    size_t result = 2;
+    while (result < n)
+        result <<= 1;
+    return result;
+}
+
+// Spin briefly, then give the CPU away. Used by the blocking push()/pop().
+class QueueBackoff
+{
+    int spins = 0;
+
+public:
+    void pause()
+    {
+        if (++spins < 64)
+            return;
+        spins = 0;
+        std::this_thread::yield();
+    }
+};
+
+// ----- Multi-producer, multi-consumer -----
+
+template <typename T>
+class MPMCQueue
+{
+    // Cells are packed (not padded) so batch operations touch few lines
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T *item() { return std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(QUEUE_CACHE_LINE) std::atomic<size_t> enqueuePos{0};
+    alignas(QUEUE_CACHE_LINE) std::atomic<size_t> dequeuePos{0};
+
+    // Claims up to `wanted` consecutive cells starting at the shared position.
+    // A cell at position p is free for producers when sequence == p and holds
+    // an item for consumers when sequence == p + 1 (offset = 0 or 1).
+    size_t claim(std::atomic<size_t> &position, size_t offset, size_t wanted, size_t &first)
+    {
+        size_t pos = position.load(std::memory_order_relaxed);
+        while (true)
+        {
+            size_t ready = 0;
+            bool behind = false;
+            while (ready < wanted)
+            {
+                size_t seq = cells[(pos + ready) & mask].sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + ready + offset);
+                if (diff != 0)
+                {
+                    // diff > 0 on the first cell: another thread moved past
+                    // pos, so our snapshot is stale
+                    behind = ready == 0 && diff > 0;
+                    break;
+                }
+                ready++;
+            }
+
+            if (ready == 0)
+            {
+                if (!behind)
+                    return 0; // full (push) or empty (pop)
+                pos = position.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (position.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed))
+            {
+                first = pos;
+                return ready;
+            }
+            // CAS failure reloaded pos; try again
+        }
+    }
+
+public:
+    explicit MPMCQueue(size_t capacity)
+        : mask(roundUpToPowerOfTwo(capacity) - 1), cells(new Cell[mask + 1])
+    {
+        for (size_t i = 0; i <= mask; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // No other thread may use the queue any more; destroy what is left
+    ~MPMCQueue()
+    {
+        size_t end = enqueuePos.load(std::memory_order_relaxed);
+        for (size_t pos = dequeuePos.load(std::memory_order_relaxed); pos != end; pos++)
+        {
+            Cell &cell = cells[pos & mask];
+            if (cell.sequence.load(std::memory_order_relaxed) == pos + 1)
+                cell.item()->~T();
+        }
+    }
+
+    MPMCQueue(const MPMCQueue &) = delete;
+    MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    template <typename U>
+    bool tryPush(U &&value)
+    {
+        size_t pos;
+        if (claim(enqueuePos, 0, 1, pos) == 0)
+            return false;
+        Cell &cell = cells[pos & mask];
+        new (cell.storage) T(std::forward<U>(value));
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T &out)
+    {
+        size_t pos;
+        if (claim(dequeuePos, 1, 1, pos) == 0)
+            return false;
+        Cell &cell = cells[pos & mask];
+        out = std::move(*cell.item());
+        cell.item()->~T();
+        cell.sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pushes up to `count` items from `items`; returns how many were taken
+    template <typename It>
+    size_t tryPushBatch(It items, size_t count)
+    {
+        size_t first;
+        size_t got = claim(enqueuePos, 0, count, first);
+        for (size_t i = 0; i < got; i++, ++items)
+        {
+            Cell &cell = cells[(first + i) & mask];
+            new (cell.storage) T(std::move(*items));
+            cell.sequence.store(first + i + 1, std::memory_order_release);
+        }
+        return got;
+    }
+
+    // Pops up to `count` items into `out`; returns how many were written
+    template <typename It>
+    size_t tryPopBatch(It out, size_t count)
+    {
+        size_t first;
+        size_t got = claim(dequeuePos, 1, count, first);
+        for (size_t i = 0; i < got; i++, ++out)
+        {
+            Cell &cell = cells[(first + i) & mask];
+            *out = std::move(*cell.item());
+            cell.item()->~T();
+            cell.sequence.store(first + i + mask + 1, std::memory_order_release);
+        }
+        return got;
+    }
+
+    template <typename U>
+    void push(U &&value)
+    {
+        QueueBackoff backoff;
+        while (!tryPush(std::forward<U>(value)))
+            backoff.pause();
+    }
+
+    void pop(T &out)
+    {
+        QueueBackoff backoff;
+        while (!tryPop(out))
+            backoff.pause();
+    }
+
+    // Approximate; other threads may change it at any moment
+    size_t sizeGuess() const
+    {
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        size_t head = dequeuePos.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+};
+
+// ----- Single-producer, single-consumer -----
+
+template <typename T>
+class SPSCQueue
+{
+    const size_t mask;
+    std::unique_ptr<T[]> slots;
+
+    // Producer's line: its own index plus its last view of the consumer
+    alignas(QUEUE_CACHE_LINE) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+
+    // Consumer's line
+    alignas(QUEUE_CACHE_LINE) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;
+
+    // Producer only: free cells, refreshing the consumer index only if needed
+    size_t freeSpace(size_t t, size_t wanted)
+    {
+        size_t space = mask + 1 - (t - cachedHead);
+        if (space < wanted)
+        {
+            cachedHead = head.load(std::memory_order_acquire);
+            space = mask + 1 - (t - cachedHead);
+        }
+        return space;
+    }
+
+    // Consumer only: filled cells, refreshing the producer index only if needed
+    size_t available(size_t h, size_t wanted)
+    {
+        size_t items = cachedTail - h;
+        if (items < wanted)
+        {
+            cachedTail = tail.load(std::memory_order_acquire);
+            items = cachedTail - h;
+        }
+        return items;
+    }
+
+public:
+    // Slots are default-constructed up front and reused by move-assignment
+    explicit SPSCQueue(size_t capacity)
+        : mask(roundUpToPowerOfTwo(capacity) - 1), slots(new T[mask + 1]) {}
+
+    SPSCQueue(const SPSCQueue &) = delete;
+    SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    template <typename U>
+    bool tryPush(U &&value)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (freeSpace(t, 1) == 0)
+            return false;
+        slots[t & mask] = std::forward<U>(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T &out)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (available(h, 1) == 0)
+            return false;
+        out = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // One release store publishes the whole batch
+    template <typename It>
+    size_t tryPushBatch(It items, size_t count)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t space = freeSpace(t, count);
+        size_t n = count < space ? count : space;
+        for (size_t i = 0; i < n; i++, ++items)
+            slots[(t + i) & mask] = std::move(*items);
+        if (n > 0)
+            tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    template <typename It>
+    size_t tryPopBatch(It out, size_t count)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t items = available(h, count);
+        size_t n = count < items ? count : items;
+        for (size_t i = 0; i < n; i++, ++out)
+            *out = std::move(slots[(h + i) & mask]);
+        if (n > 0)
+            head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    template <typename U>
+    void push(U &&value)
+    {
+        QueueBackoff backoff;
+        while (!tryPush(std::forward<U>(value)))
+            backoff.pause();
+    }
+
+    void pop(T &out)
+    {
+        QueueBackoff backoff;
+        while (!tryPop(out))
+            backoff.pause();
+    }
+
+    size_t sizeGuess() const
+    {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // CONCURRENT_QUEUE_H
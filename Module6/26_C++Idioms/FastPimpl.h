@@ -0,0 +1,100 @@
+// FastPimpl.h - PIMPL without the heap allocation
+//
+// The classic PIMPL holds std::unique_ptr<Impl>: every object costs one
+// allocation, and every member access goes through a pointer to another cache
+// line. FastPimpl<Impl, Size, Align> keeps the Impl inside the owning object,
+// in a raw aligned buffer, while the header still only forward-declares Impl:
+//
+//   // widget.h
+//   class Widget
+//   {
+//       struct Impl;
+//       FastPimpl<Impl, 40, 8> impl;    // size/alignment of Impl on the target
+//   public:
+//       Widget();
+//       ~Widget();                      // all special members defined in widget.cpp
+//   };
+//
+//   // widget.cpp
+//   struct Widget::Impl { std::string name; int revision = 1; };
+//   Widget::Widget() = default;         // constructs Impl in place
+//   Widget::~Widget() = default;
+//
+// The compile firewall stays: Impl's members and includes remain private to
+// the .cpp. What the header does fix is Impl's size, so growing Impl means
+// editing one number there. static_asserts in FastPimpl's destructor (which
+// is only instantiated where Impl is complete) turn a wrong Size or Align into
+// a compile error that states the required value, never into a silent overflow.
+//
+// Differences from unique_ptr<Impl>:
+//   - there is no null state. A moved-from object holds a moved-from Impl, so
+//     Impl's move operations decide what "empty" means
+//   - copying and moving copy/move the Impl (the wrapper itself is cheap to
+//     move only if Impl is)
+//   - every special member of the owning class must be defined in the .cpp,
+//     like the destructor already had to be with unique_ptr
+
+#ifndef FAST_PIMPL_H
+#define FAST_PIMPL_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Impl, std::size_t Size, std::size_t Align = alignof(std::max_align_t)>
+class FastPimpl
+{
+    alignas(Align) unsigned char storage[Size];
+
+    Impl *get() noexcept { return std::launder(reinterpret_cast<Impl *>(storage)); }
+    const Impl *get() const noexcept { return std::launder(reinterpret_cast<const Impl *>(storage)); }
+
+    // Template parameters put the actual values into the error message
+    template <std::size_t ActualSize, std::size_t ActualAlign>
+    static void validate() noexcept
+    {
+        static_assert(Size >= ActualSize, "FastPimpl: Size is smaller than sizeof(Impl); see ActualSize");
+        static_assert(Align % ActualAlign == 0, "FastPimpl: Align is not a multiple of alignof(Impl); see ActualAlign");
+    }
+
+public:
+    // Forwards to Impl's constructor (not used for copies of FastPimpl itself)
+    template <typename... Args,
+              typename = std::enable_if_t<!(sizeof...(Args) == 1 && (std::is_same_v<std::decay_t<Args>, FastPimpl> && ...))>>
+    explicit FastPimpl(Args &&...args)
+    {
+        new (storage) Impl(std::forward<Args>(args)...);
+    }
+
+    FastPimpl(const FastPimpl &other) { new (storage) Impl(*other); }
+    FastPimpl(FastPimpl &&other) noexcept(std::is_nothrow_move_constructible_v<Impl>)
+    {
+        new (storage) Impl(std::move(*other));
+    }
+
+    FastPimpl &operator=(const FastPimpl &other)
+    {
+        *get() = *other;
+        return *this;
+    }
+
+    FastPimpl &operator=(FastPimpl &&other) noexcept(std::is_nothrow_move_assignable_v<Impl>)
+    {
+        *get() = std::move(*other);
+        return *this;
+    }
+
+    ~FastPimpl()
+    {
+        validate<sizeof(Impl), alignof(Impl)>();
+        get()->~Impl();
+    }
+
+    Impl *operator->() noexcept { return get(); }
+    const Impl *operator->() const noexcept { return get(); }
+    Impl &operator*() noexcept { return *get(); }
+    const Impl &operator*() const noexcept { return *get(); }
+};
+
+#endif // FAST_PIMPL_H
@@ -0,0 +1,426 @@
+// ProfiledMutex.h - A std::mutex that measures its own contention
+//
+// Compile with -DLOCK_PROFILING to turn profiling on. Without it, ProfiledMutex
+// is a plain std::mutex and PROFILED_LOCK_GUARD is a plain std::lock_guard, so
+// the instrumentation can stay in the code at zero cost.
+//
+// For every lock site the profiler records:
+//   - acquisitions, and how many of them found the mutex already locked
+//   - wait time (lock() call until the mutex is owned)
+//   - hold time (owned until unlock())
+// Wait and hold times also go into log2 histograms (1 ns .. ~1 s) so the
+// report can show tail percentiles and not just averages.
+//
+// A "site" is either the mutex itself (its name, for std::lock_guard /
+// std::unique_lock) or a specific PROFILED_LOCK_GUARD line, so two places
+// that lock the same mutex can be told apart.
+//
+// Usage:
+//   ProfiledMutex queueMutex("job queue");
+//   {
+//       std::lock_guard<ProfiledMutex> lock(queueMutex);   // counted as "job queue"
+//   }
+//   {
+//       PROFILED_LOCK_GUARD(lock, queueMutex);             // counted as "job queue @ file:line"
+//   }
+//   printLockProfile(std::cout);                           // sorted by total wait
+//
+// Overhead when enabled: an uncontended acquisition costs one try_lock and two
+// steady_clock reads (acquire and release); the statistics live in per-thread tables, so recording
+// never touches a cache line that another thread writes.
+
+#ifndef PROFILED_MUTEX_H
+#define PROFILED_MUTEX_H
+
+#include <mutex>
+#include <ostream>
+
+#ifndef LOCK_PROFILING
+
+class ProfiledMutex : public std::mutex
+{
+public:
+    explicit ProfiledMutex(const char * = nullptr) {}
+};
+
+#define PROFILED_LOCK_GUARD(var, mutex) std::lock_guard<ProfiledMutex> var(mutex)
+
+inline void printLockProfile(std::ostream &os)
+{
+    os << "Lock profiling is disabled (compile with -DLOCK_PROFILING)\n";
+}
+
+inline void resetLockProfile() {}
+
+#else // LOCK_PROFILING
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../Module4/18_IOStreams/TableFormatter.h"
+
+namespace lockprofile
+{
+    constexpr size_t MAX_SITES = 128; // later sites share the last slot
+    constexpr int BUCKETS = 32;       // bucket b holds durations below 2^b ns
+
+    inline int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    inline int bucketOf(int64_t ns)
+    {
+        if (ns <= 0)
+            return 0;
+        int b = 64 - __builtin_clzll((unsigned long long)ns);
+        return b < BUCKETS ? b : BUCKETS - 1;
+    }
+
+    // One per site per thread. Each table has a single writer (its thread),
+    // so counters are bumped with relaxed load + store, no locked instructions;
+    // the atomics only make it safe for the report to read them concurrently.
+    struct SiteStats
+    {
+        std::atomic<uint64_t> acquisitions{0};
+        std::atomic<uint64_t> contended{0};
+        std::atomic<uint64_t> waitNs{0};
+        std::atomic<uint64_t> holdNs{0};
+        std::atomic<uint64_t> maxWaitNs{0};
+        std::atomic<uint64_t> maxHoldNs{0};
+        std::atomic<uint64_t> waitHistogram[BUCKETS] = {};
+        std::atomic<uint64_t> holdHistogram[BUCKETS] = {};
+
+        void clear()
+        {
+            for (std::atomic<uint64_t> *value : {&acquisitions, &contended, &waitNs, &holdNs, &maxWaitNs, &maxHoldNs})
+                value->store(0, std::memory_order_relaxed);
+            for (int b = 0; b < BUCKETS; b++)
+            {
+                waitHistogram[b].store(0, std::memory_order_relaxed);
+                holdHistogram[b].store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    inline void bump(std::atomic<uint64_t> &value, uint64_t by)
+    {
+        value.store(value.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    inline void raise(std::atomic<uint64_t> &value, uint64_t candidate)
+    {
+        if (candidate > value.load(std::memory_order_relaxed))
+            value.store(candidate, std::memory_order_relaxed);
+    }
+
+    // A thread's statistics. Live tables register with the Registry so the
+    // report can see them; detached ones (totals) do not.
+    struct ThreadTable
+    {
+        std::unique_ptr<SiteStats[]> sites{new SiteStats[MAX_SITES]};
+        bool live;
+        explicit ThreadTable(bool registerThread = true);
+        ~ThreadTable();
+    };
+
+    struct SiteInfo
+    {
+        std::string name;
+    };
+
+    // Site names, live per-thread tables, and totals of threads that have exited
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<SiteInfo> sites;
+        std::vector<ThreadTable *> threads;
+        ThreadTable retired{false};
+
+        static Registry &instance()
+        {
+            static Registry *registry = new Registry(); // never destroyed: threads may outlive main
+            return *registry;
+        }
+
+        size_t addSite(std::string name)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (sites.size() == MAX_SITES - 1)
+                sites.push_back(SiteInfo{"(other sites)"});
+            if (sites.size() >= MAX_SITES)
+                return MAX_SITES - 1;
+            sites.push_back(SiteInfo{std::move(name)});
+            return sites.size() - 1;
+        }
+
+    private:
+        Registry() = default;
+    };
+
+    inline void mergeInto(SiteStats &to, const SiteStats &from)
+    {
+        bump(to.acquisitions, from.acquisitions.load(std::memory_order_relaxed));
+        bump(to.contended, from.contended.load(std::memory_order_relaxed));
+        bump(to.waitNs, from.waitNs.load(std::memory_order_relaxed));
+        bump(to.holdNs, from.holdNs.load(std::memory_order_relaxed));
+        raise(to.maxWaitNs, from.maxWaitNs.load(std::memory_order_relaxed));
+        raise(to.maxHoldNs, from.maxHoldNs.load(std::memory_order_relaxed));
+        for (int b = 0; b < BUCKETS; b++)
+        {
+            bump(to.waitHistogram[b], from.waitHistogram[b].load(std::memory_order_relaxed));
+            bump(to.holdHistogram[b], from.holdHistogram[b].load(std::memory_order_relaxed));
+        }
+    }
+
+    inline ThreadTable::ThreadTable(bool registerThread) : live(registerThread)
+    {
+        if (!live)
+            return;
+        Registry &registry = Registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.push_back(this);
+    }
+
+    // A finished thread's numbers are folded into Registry::retired
+    inline ThreadTable::~ThreadTable()
+    {
+        if (!live)
+            return;
+        Registry &registry = Registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (size_t s = 0; s < MAX_SITES; s++)
+            mergeInto(registry.retired.sites[s], sites[s]);
+        registry.threads.erase(std::remove(registry.threads.begin(), registry.threads.end(), this),
+                               registry.threads.end());
+    }
+
+    inline SiteStats &statsFor(size_t site)
+    {
+        thread_local ThreadTable table;
+        return table.sites[site];
+    }
+
+    inline void record(size_t site, bool contended, int64_t waitNs, int64_t holdNs)
+    {
+        SiteStats &stats = statsFor(site);
+        bump(stats.acquisitions, 1);
+        if (contended)
+            bump(stats.contended, 1);
+        bump(stats.waitNs, (uint64_t)waitNs);
+        bump(stats.holdNs, (uint64_t)holdNs);
+        raise(stats.maxWaitNs, (uint64_t)waitNs);
+        raise(stats.maxHoldNs, (uint64_t)holdNs);
+        bump(stats.waitHistogram[bucketOf(waitNs)], 1);
+        bump(stats.holdHistogram[bucketOf(holdNs)], 1);
+    }
+
+    // Upper bound of the histogram bucket containing the given quantile,
+    // capped at the recorded maximum so p99 never reads above max
+    inline double percentileUs(const uint64_t *histogram, uint64_t count, double quantile, uint64_t maxNs)
+    {
+        uint64_t target = (uint64_t)((double)count * quantile);
+        uint64_t seen = 0;
+        uint64_t bound = maxNs;
+        for (int b = 0; b < BUCKETS; b++)
+        {
+            seen += histogram[b];
+            if (seen > target)
+            {
+                bound = 1ULL << b;
+                break;
+            }
+        }
+        return (double)std::min(bound, maxNs) / 1000.0;
+    }
+} // namespace lockprofile
+
+class ProfiledMutex
+{
+    std::mutex mutex;
+    size_t ownSite;
+    // Written only by the thread that holds the mutex
+    size_t holderSite = 0;
+    bool holderContended = false;
+    int64_t waitNs = 0;
+    int64_t acquiredNs = 0;
+
+public:
+    explicit ProfiledMutex(const char *name = "unnamed mutex")
+        : ownSite(lockprofile::Registry::instance().addSite(name)) {}
+
+    ProfiledMutex(const ProfiledMutex &) = delete;
+    ProfiledMutex &operator=(const ProfiledMutex &) = delete;
+
+    size_t site() const { return ownSite; }
+
+    // Locks and attributes the acquisition to `site`
+    void lockAt(size_t site)
+    {
+        // Only a failed try_lock starts the wait clock, so an uncontended
+        // acquisition costs one clock read here and one in unlock()
+        int64_t wait = 0;
+        int64_t acquired;
+        bool contended = !mutex.try_lock();
+        if (!contended)
+        {
+            acquired = lockprofile::nowNs();
+        }
+        else
+        {
+            int64_t start = lockprofile::nowNs();
+            mutex.lock();
+            acquired = lockprofile::nowNs();
+            wait = acquired - start;
+        }
+        holderSite = site;
+        holderContended = contended;
+        waitNs = wait;
+        acquiredNs = acquired;
+    }
+
+    void lock() { lockAt(ownSite); }
+
+    bool try_lock()
+    {
+        if (!mutex.try_lock())
+            return false;
+        holderSite = ownSite;
+        holderContended = false;
+        waitNs = 0;
+        acquiredNs = lockprofile::nowNs();
+        return true;
+    }
+
+    void unlock()
+    {
+        // Copy the holder's data before another thread can take the mutex
+        size_t site = holderSite;
+        bool contended = holderContended;
+        int64_t wait = waitNs;
+        int64_t hold = lockprofile::nowNs() - acquiredNs;
+        mutex.unlock();
+        lockprofile::record(site, contended, wait, hold);
+    }
+};
+
+// Like std::lock_guard<ProfiledMutex>, but counted under its own call site
+class ProfiledLockGuard
+{
+    ProfiledMutex &mutex;
+
+public:
+    ProfiledLockGuard(ProfiledMutex &m, size_t site) : mutex(m) { mutex.lockAt(site); }
+    ~ProfiledLockGuard() { mutex.unlock(); }
+    ProfiledLockGuard(const ProfiledLockGuard &) = delete;
+    ProfiledLockGuard &operator=(const ProfiledLockGuard &) = delete;
+};
+
+// Registers "<mutex name> @ file:line" once per call site (function-local static)
+inline size_t registerLockSite(const ProfiledMutex &mutex, const char *file, int line)
+{
+    lockprofile::Registry &registry = lockprofile::Registry::instance();
+    std::string name;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        name = registry.sites[mutex.site()].name;
+    }
+    std::string path(file);
+    size_t slash = path.find_last_of("/\\");
+    return registry.addSite(name + " @ " + path.substr(slash == std::string::npos ? 0 : slash + 1) + ":" +
+                            std::to_string(line));
+}
+
+#define PROFILED_LOCK_GUARD(var, mutex)                                                  \
+    static const size_t var##LockSite = registerLockSite((mutex), __FILE__, __LINE__); \
+    ProfiledLockGuard var((mutex), var##LockSite)
+
+// Clears all statistics. Call while no thread is locking profiled mutexes.
+inline void resetLockProfile()
+{
+    using namespace lockprofile;
+    Registry &registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto clear = [](ThreadTable &table)
+    {
+        for (size_t s = 0; s < MAX_SITES; s++)
+            table.sites[s].clear();
+    };
+    clear(registry.retired);
+    for (ThreadTable *table : registry.threads)
+        clear(*table);
+}
+
+// Merges all threads' tables and prints one row per site, sorted by total wait
+inline void printLockProfile(std::ostream &os)
+{
+    using namespace lockprofile;
+    Registry &registry = Registry::instance();
+    std::vector<std::string> names;
+    ThreadTable total(false);
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const SiteInfo &site : registry.sites)
+            names.push_back(site.name);
+        for (size_t s = 0; s < names.size(); s++)
+        {
+            mergeInto(total.sites[s], registry.retired.sites[s]);
+            for (ThreadTable *table : registry.threads)
+                mergeInto(total.sites[s], table->sites[s]);
+        }
+    }
+
+    std::vector<size_t> order;
+    for (size_t s = 0; s < names.size(); s++)
+        if (total.sites[s].acquisitions.load() > 0)
+            order.push_back(s);
+    std::sort(order.begin(), order.end(), [&total](size_t a, size_t b)
+              { return total.sites[a].waitNs.load() > total.sites[b].waitNs.load(); });
+
+    TableFormatter table;
+    table.addColumn("Lock site")
+        .addColumn("Acquired", TableFormatter::Right)
+        .addColumn("Contended %", TableFormatter::Right, 1)
+        .addColumn("Wait ms", TableFormatter::Right, 3)
+        .addColumn("Wait p99 us", TableFormatter::Right, 3)
+        .addColumn("Wait max us", TableFormatter::Right, 1)
+        .addColumn("Hold ms", TableFormatter::Right, 3)
+        .addColumn("Hold p99 us", TableFormatter::Right, 3)
+        .addColumn("Hold max us", TableFormatter::Right, 1);
+    for (size_t s : order)
+    {
+        const SiteStats &stats = total.sites[s];
+        uint64_t count = stats.acquisitions.load();
+        uint64_t waitHistogram[BUCKETS];
+        uint64_t holdHistogram[BUCKETS];
+        for (int b = 0; b < BUCKETS; b++)
+        {
+            waitHistogram[b] = stats.waitHistogram[b].load();
+            holdHistogram[b] = stats.holdHistogram[b].load();
+        }
+        table.cell(names[s])
+            .cell((unsigned long long)count)
+            .cell(100.0 * (double)stats.contended.load() / (double)count)
+            .cell((double)stats.waitNs.load() / 1e6)
+            .cell(percentileUs(waitHistogram, count, 0.99, stats.maxWaitNs.load()))
+            .cell((double)stats.maxWaitNs.load() / 1000.0)
+            .cell((double)stats.holdNs.load() / 1e6)
+            .cell(percentileUs(holdHistogram, count, 0.99, stats.maxHoldNs.load()))
+            .cell((double)stats.maxHoldNs.load() / 1000.0)
+            .endRow();
+    }
+    os << "== Lock profile (p99 = histogram bucket upper bound, capped at max) ==\n";
+    table.print(os);
+}
+
+#endif // LOCK_PROFILING
+
+#endif // PROFILED_MUTEX_H
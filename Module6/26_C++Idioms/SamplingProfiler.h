@@ -0,0 +1,506 @@
+// SamplingProfiler.h - In-process sampling CPU profiler (Linux)
+//
+// PROFILE_SCOPE and measureTime only see the code somebody decided to
+// instrument. This profiler needs no instrumentation: setitimer(ITIMER_PROF)
+// makes the kernel send SIGPROF every 1/hz seconds of CPU time used by the
+// process, and the signal handler records the interrupted thread's call stack.
+// After the run, stacks are symbolized and aggregated:
+//   - writeCollapsed("out.folded") writes one "main;parse;readLine 42" line per
+//     distinct stack, the input format of flamegraph.pl, speedscope and
+//     https://www.speedscope.app (no external tool is needed to record)
+//   - printTop(cout) lists the functions with the most samples (self/total)
+//
+// Usage:
+//   {
+//       SamplingProfilerSession session("run.folded");   // start(), then stop() + write at scope exit
+//       runWorkload();
+//   }
+//
+// Signal-handler safety: the handler only uses a preallocated sample array, an
+// atomic index and glibc's backtrace(). backtrace() loads its unwinder on first
+// use, which is not async-signal-safe, so start() calls it once beforehand.
+// Stacks are walked with the unwind tables (no frame pointers needed);
+// inlined functions are attributed to their caller.
+//
+// Symbols come from dladdr() for shared libraries and from the executable's
+// own .symtab, read from /proc/self/exe, so static functions resolve without
+// -rdynamic. A stripped binary falls back to "module+0xoffset".
+//
+// start() saves the previous SIGPROF disposition and stop() restores it, so a
+// host's own SIGPROF handler (another profiler, gperftools) keeps working
+// after a session. On other systems start() returns false and the writers
+// produce nothing.
+
+#ifndef SAMPLING_PROFILER_H
+#define SAMPLING_PROFILER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__) && defined(__GLIBC__)
+#define SAMPLING_PROFILER_SUPPORTED 1
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <elf.h>
+#include <execinfo.h>
+#include <link.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#endif
+
+#include "../../Module4/18_IOStreams/TableFormatter.h"
+
+class SamplingProfiler
+{
+public:
+    static const int MAX_DEPTH = 64;
+
+    struct Sample
+    {
+        std::atomic<bool> ready{false};
+        int depth = 0;
+        void *frames[MAX_DEPTH]; // leaf first
+    };
+
+private:
+    struct State
+    {
+        std::unique_ptr<Sample[]> samples;
+        size_t capacity = 0;
+        std::atomic<size_t> next{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> running{false};
+        int hz = 0;
+#ifdef SAMPLING_PROFILER_SUPPORTED
+        struct sigaction previous;
+#endif
+    };
+
+    static State &state()
+    {
+        static State s;
+        return s;
+    }
+
+#ifdef SAMPLING_PROFILER_SUPPORTED
+    static void *interruptedPc(void *context)
+    {
+        ucontext_t *uc = static_cast<ucontext_t *>(context);
+#if defined(__x86_64__)
+        return (void *)uc->uc_mcontext.gregs[REG_RIP];
+#elif defined(__i386__)
+        return (void *)uc->uc_mcontext.gregs[REG_EIP];
+#elif defined(__aarch64__)
+        return (void *)uc->uc_mcontext.pc;
+#else
+        (void)uc;
+        return nullptr;
+#endif
+    }
+
+    static void onSignal(int, siginfo_t *, void *context)
+    {
+        int savedErrno = errno;
+        State &s = state();
+        size_t index = s.next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= s.capacity)
+        {
+            s.dropped.fetch_add(1, std::memory_order_relaxed);
+            errno = savedErrno;
+            return;
+        }
+
+        // The first frames belong to this handler and the signal trampoline;
+        // the stack of interest starts at the interrupted instruction
+        void *raw[MAX_DEPTH + 4];
+        int n = backtrace(raw, MAX_DEPTH + 4);
+        void *pc = interruptedPc(context);
+        int first = n > 2 ? 2 : 0;
+        for (int i = 0; i < n && i < 4; i++)
+        {
+            if (raw[i] == pc)
+            {
+                first = i;
+                break;
+            }
+        }
+
+        Sample &sample = s.samples[index];
+        int depth = 0;
+        for (int i = first; i < n && depth < MAX_DEPTH; i++)
+            sample.frames[depth++] = raw[i];
+        sample.depth = depth;
+        sample.ready.store(true, std::memory_order_release);
+        errno = savedErrno;
+    }
+
+    // Function symbols of the main executable, from its .symtab (or .dynsym)
+    struct ElfSymbols
+    {
+        struct Symbol
+        {
+            uintptr_t start;
+            uintptr_t size;
+            std::string name;
+        };
+        std::vector<Symbol> symbols; // sorted by start, load bias applied
+        uintptr_t low = 0;
+        uintptr_t high = 0;
+
+        void load()
+        {
+            struct Range
+            {
+                uintptr_t bias = 0, low = UINTPTR_MAX, high = 0;
+                bool done = false;
+            } range;
+            dl_iterate_phdr([](dl_phdr_info *info, size_t, void *data)
+                            {
+                Range *r = static_cast<Range *>(data);
+                if (r->done)
+                    return 1;
+                // The first object reported is the main program
+                r->bias = info->dlpi_addr;
+                for (int i = 0; i < info->dlpi_phnum; i++)
+                {
+                    const ElfW(Phdr) &ph = info->dlpi_phdr[i];
+                    if (ph.p_type != PT_LOAD)
+                        continue;
+                    r->low = std::min(r->low, (uintptr_t)(info->dlpi_addr + ph.p_vaddr));
+                    r->high = std::max(r->high, (uintptr_t)(info->dlpi_addr + ph.p_vaddr + ph.p_memsz));
+                }
+                r->done = true;
+                return 1; }, &range);
+            low = range.low;
+            high = range.high;
+
+            std::ifstream file("/proc/self/exe", std::ios::binary);
+            std::vector<char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            if (image.size() < sizeof(ElfW(Ehdr)))
+                return;
+            const ElfW(Ehdr) *header = reinterpret_cast<const ElfW(Ehdr) *>(image.data());
+            if (memcmp(header->e_ident, ELFMAG, SELFMAG) != 0 || header->e_shoff == 0 ||
+                header->e_shoff + (size_t)header->e_shnum * sizeof(ElfW(Shdr)) > image.size())
+                return;
+            const ElfW(Shdr) *sections = reinterpret_cast<const ElfW(Shdr) *>(image.data() + header->e_shoff);
+
+            for (unsigned type : {(unsigned)SHT_SYMTAB, (unsigned)SHT_DYNSYM})
+            {
+                for (int i = 0; i < header->e_shnum; i++)
+                {
+                    const ElfW(Shdr) &table = sections[i];
+                    if (table.sh_type != type || table.sh_link >= header->e_shnum)
+                        continue;
+                    const ElfW(Shdr) &strings = sections[table.sh_link];
+                    if (table.sh_offset + table.sh_size > image.size() || strings.sh_offset + strings.sh_size > image.size())
+                        continue;
+                    const ElfW(Sym) *syms = reinterpret_cast<const ElfW(Sym) *>(image.data() + table.sh_offset);
+                    size_t count = table.sh_size / sizeof(ElfW(Sym));
+                    for (size_t k = 0; k < count; k++)
+                    {
+                        if (ELF64_ST_TYPE(syms[k].st_info) != STT_FUNC || syms[k].st_value == 0 ||
+                            syms[k].st_name >= strings.sh_size)
+                            continue;
+                        symbols.push_back(Symbol{range.bias + (uintptr_t)syms[k].st_value, (uintptr_t)syms[k].st_size,
+                                                 demangle(image.data() + strings.sh_offset + syms[k].st_name)});
+                    }
+                }
+                if (!symbols.empty())
+                    break;
+            }
+            std::sort(symbols.begin(), symbols.end(), [](const Symbol &a, const Symbol &b)
+                      { return a.start < b.start; });
+        }
+
+        const std::string *find(uintptr_t address) const
+        {
+            auto it = std::upper_bound(symbols.begin(), symbols.end(), address, [](uintptr_t a, const Symbol &s)
+                                       { return a < s.start; });
+            if (it == symbols.begin())
+                return nullptr;
+            --it;
+            if (address >= it->start + std::max<uintptr_t>(it->size, 1))
+                return nullptr;
+            return &it->name;
+        }
+    };
+#endif
+
+    static std::string demangle(const char *name)
+    {
+#ifdef SAMPLING_PROFILER_SUPPORTED
+        int status = 0;
+        char *readable = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status == 0 && readable != nullptr)
+        {
+            std::string result(readable);
+            free(readable);
+            return result;
+        }
+#endif
+        return name;
+    }
+
+    // Copies the finished samples out of the signal buffer
+    static std::vector<const Sample *> collected()
+    {
+        State &s = state();
+        std::vector<const Sample *> result;
+        size_t end = std::min(s.next.load(), s.capacity);
+        for (size_t i = 0; i < end; i++)
+            if (s.samples[i].ready.load(std::memory_order_acquire))
+                result.push_back(&s.samples[i]);
+        return result;
+    }
+
+    // Stack keys (root first, ';'-separated) with their sample counts
+    static std::map<std::string, uint64_t> aggregate()
+    {
+        std::map<std::string, uint64_t> stacks;
+#ifdef SAMPLING_PROFILER_SUPPORTED
+        ElfSymbols executable;
+        executable.load();
+        std::unordered_map<void *, std::string> cache;
+
+        auto symbolize = [&](void *frame, bool leaf) -> const std::string &
+        {
+            // Return addresses point after the call; look up the call itself
+            void *lookup = leaf ? frame : (void *)((uintptr_t)frame - 1);
+            auto found = cache.find(lookup);
+            if (found != cache.end())
+                return found->second;
+
+            std::string name;
+            uintptr_t address = (uintptr_t)lookup;
+            Dl_info info;
+            bool haveInfo = dladdr(lookup, &info) != 0;
+            if (address >= executable.low && address < executable.high)
+            {
+                if (const std::string *symbol = executable.find(address))
+                    name = *symbol;
+            }
+            if (name.empty() && haveInfo && info.dli_sname != nullptr)
+                name = demangle(info.dli_sname);
+            if (name.empty())
+            {
+                char text[64];
+                if (haveInfo && info.dli_fname != nullptr)
+                {
+                    const char *module = strrchr(info.dli_fname, '/');
+                    snprintf(text, sizeof(text), "%s+0x%lx", module ? module + 1 : info.dli_fname,
+                             (unsigned long)(address - (uintptr_t)info.dli_fbase));
+                }
+                else
+                {
+                    snprintf(text, sizeof(text), "0x%lx", (unsigned long)address);
+                }
+                name = text;
+            }
+            // ';' separates frames in the collapsed format
+            std::replace(name.begin(), name.end(), ';', ':');
+            return cache.emplace(lookup, name).first->second;
+        };
+
+        for (const Sample *sample : collected())
+        {
+            std::string key;
+            for (int i = sample->depth - 1; i >= 0; i--)
+            {
+                if (!key.empty())
+                    key += ';';
+                key += symbolize(sample->frames[i], i == 0);
+            }
+            if (!key.empty())
+                stacks[key]++;
+        }
+#endif
+        return stacks;
+    }
+
+public:
+    // Starts sampling every 1/hz seconds of process CPU time. Memory for
+    // maxSamples stacks is allocated up front; later samples are counted as
+    // dropped. Returns false if unsupported or already running.
+    static bool start(int hz = 999, size_t maxSamples = 1 << 16)
+    {
+#ifdef SAMPLING_PROFILER_SUPPORTED
+        State &s = state();
+        if (s.running.load() || hz <= 0)
+            return false;
+        s.samples.reset(new Sample[maxSamples]);
+        s.capacity = maxSamples;
+        s.next.store(0);
+        s.dropped.store(0);
+        s.hz = hz;
+
+        void *warmUp[4];
+        backtrace(warmUp, 4);
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = onSignal;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, &s.previous) != 0)
+            return false;
+
+        itimerval timer;
+        timer.it_interval.tv_sec = 0;
+        timer.it_interval.tv_usec = hz >= 1000000 ? 1 : 1000000 / hz;
+        timer.it_value = timer.it_interval;
+        if (setitimer(ITIMER_PROF, &timer, nullptr) != 0)
+        {
+            sigaction(SIGPROF, &s.previous, nullptr);
+            return false;
+        }
+        s.running.store(true);
+        return true;
+#else
+        (void)hz;
+        (void)maxSamples;
+        return false;
+#endif
+    }
+
+    static void stop()
+    {
+#ifdef SAMPLING_PROFILER_SUPPORTED
+        State &s = state();
+        if (!s.running.exchange(false))
+            return;
+        itimerval off;
+        memset(&off, 0, sizeof(off));
+        setitimer(ITIMER_PROF, &off, nullptr);
+
+        // A SIGPROF generated just before the timer was disarmed may still be
+        // pending, and must not reach the restored disposition (the default
+        // one terminates the process). Block it here, consume it, and only
+        // then give SIGPROF back; until then our handler still catches any
+        // other thread that dequeues it first.
+        sigset_t prof, oldMask;
+        sigemptyset(&prof);
+        sigaddset(&prof, SIGPROF);
+        pthread_sigmask(SIG_BLOCK, &prof, &oldMask);
+        timespec noWait = {0, 0};
+        while (sigtimedwait(&prof, nullptr, &noWait) == SIGPROF)
+        {
+        }
+        sigaction(SIGPROF, &s.previous, nullptr);
+        pthread_sigmask(SIG_SETMASK, &oldMask, nullptr);
+#endif
+    }
+
+    static size_t sampleCount() { return std::min(state().next.load(), state().capacity); }
+    static uint64_t droppedCount() { return state().dropped.load(); }
+
+    // Collapsed stacks for flame graph tools; call after stop()
+    static bool writeCollapsed(const std::string &path)
+    {
+        std::ofstream out(path);
+        if (!out)
+            return false;
+        for (const auto &stack : aggregate())
+            out << stack.first << ' ' << stack.second << '\n';
+        return (bool)out;
+    }
+
+    // Functions by self samples (leaf frame), with inclusive counts
+    static void printTop(std::ostream &os, size_t count = 15)
+    {
+        std::map<std::string, std::pair<uint64_t, uint64_t>> functions; // self, total
+        uint64_t samples = 0;
+        for (const auto &stack : aggregate())
+        {
+            samples += stack.second;
+            std::vector<std::string> frames;
+            size_t begin = 0;
+            while (true)
+            {
+                size_t end = stack.first.find(';', begin);
+                frames.push_back(stack.first.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+                if (end == std::string::npos)
+                    break;
+                begin = end + 1;
+            }
+            std::sort(frames.begin(), frames.end() - 1); // count recursion once
+            for (size_t i = 0; i + 1 < frames.size(); i++)
+                if (i == 0 || frames[i] != frames[i - 1])
+                    functions[frames[i]].second += stack.second;
+            functions[frames.back()].first += stack.second;
+            if (std::find(frames.begin(), frames.end() - 1, frames.back()) == frames.end() - 1)
+                functions[frames.back()].second += stack.second;
+        }
+
+        std::vector<std::pair<std::string, std::pair<uint64_t, uint64_t>>> ranked(functions.begin(), functions.end());
+        std::sort(ranked.begin(), ranked.end(), [](const auto &a, const auto &b)
+                  { return a.second.first != b.second.first ? a.second.first > b.second.first
+                                                            : a.second.second > b.second.second; });
+
+        TableFormatter table;
+        table.addColumn("Self %", TableFormatter::Right, 1)
+            .addColumn("Total %", TableFormatter::Right, 1)
+            .addColumn("Samples", TableFormatter::Right)
+            .addColumn("Function");
+        for (size_t i = 0; i < ranked.size() && i < count; i++)
+        {
+            const auto &entry = ranked[i];
+            std::string name = entry.first.size() > 100 ? entry.first.substr(0, 97) + "..." : entry.first;
+            table.cell(100.0 * (double)entry.second.first / (double)samples)
+                .cell(100.0 * (double)entry.second.second / (double)samples)
+                .cell((unsigned long long)entry.second.first)
+                .cell(name)
+                .endRow();
+        }
+        os << "== Sampling profile: " << samples << " samples at " << state().hz << " Hz";
+        if (droppedCount() > 0)
+            os << ", " << droppedCount() << " dropped";
+        os << " ==\n";
+        table.print(os);
+    }
+};
+
+// RAII: samples for the lifetime of the object, then writes the collapsed
+// stacks (if a path was given) and prints the top functions
+class SamplingProfilerSession
+{
+    std::string path;
+    std::ostream *report;
+    bool active;
+
+public:
+    explicit SamplingProfilerSession(const std::string &collapsedPath = "", std::ostream *topReport = nullptr,
+                                     int hz = 999)
+        : path(collapsedPath), report(topReport), active(SamplingProfiler::start(hz)) {}
+
+    ~SamplingProfilerSession()
+    {
+        if (!active)
+            return;
+        SamplingProfiler::stop();
+        if (!path.empty() && !SamplingProfiler::writeCollapsed(path) && report != nullptr)
+            *report << "Could not write " << path << "\n";
+        if (report != nullptr)
+            SamplingProfiler::printTop(*report);
+    }
+
+    bool isActive() const { return active; }
+
+    SamplingProfilerSession(const SamplingProfilerSession &) = delete;
+    SamplingProfilerSession &operator=(const SamplingProfilerSession &) = delete;
+};
+
+#endif // SAMPLING_PROFILER_H
@@ -0,0 +1,660 @@
+// ScopeProfiler.h - Aggregating scoped profiler (the Timer idea, without the printing)
+//
+// Task5's Timer prints a line per scope, which costs microseconds of I/O inside
+// the code being measured and leaves the adding-up to the reader. PROFILE_SCOPE
+// records instead:
+//   - every thread keeps its own call tree (a node per distinct path of labels),
+//     so entering and leaving a scope touches only thread-local memory
+//   - each node counts calls, total/min/max time and a log2 histogram
+//   - timestamps are raw TSC ticks on x86 (rdtsc), steady_clock elsewhere;
+//     ticks are converted to time only when the report is printed
+//   - the report (call tree + flat per-label table) is printed at exit, or on
+//     demand with printScopeProfile()
+//
+// Tracing: between startScopeTrace() and writeScopeTrace("trace.json") every
+// scope also leaves one complete ("X") event in a per-thread ring buffer, and
+// TRACE_COUNTER(name, value) adds counter samples. The file is Chrome
+// trace-event JSON for chrome://tracing or https://ui.perfetto.dev, with one
+// track per thread and nesting shown by time containment. Each ring holds a
+// fixed number of events; when it is full the oldest are overwritten, so a
+// long run keeps its most recent window at bounded memory. Rings of exited
+// threads share one global event budget (oldest threads are evicted first),
+// and each startScopeTrace() starts a new session that discards the previous
+// session's events.
+//
+// Usage:
+//   void parse()
+//   {
+//       PROFILE_SCOPE("parse");
+//       for (...) { PROFILE_SCOPE("parse/line"); ... }
+//   }
+//
+// Define NO_SCOPE_PROFILING to compile every PROFILE_SCOPE and TRACE_COUNTER
+// away entirely.
+//
+// Labels are copied and registered once per call site; call sites with the
+// same label text share one entry. Trees of threads that have exited are merged
+// into the totals, so short-lived worker threads are not lost.
+// printScopeProfile() must not run while other threads are inside profiled
+// scopes; the exit report runs after main returns, when that holds.
+
+#ifndef SCOPE_PROFILER_H
+#define SCOPE_PROFILER_H
+
+#include <ostream>
+
+#ifdef NO_SCOPE_PROFILING
+
+#include <string>
+
+#define PROFILE_SCOPE(label) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+
+inline void printScopeProfile(std::ostream &) {}
+inline void setScopeProfileReportAtExit(bool) {}
+inline void startScopeTrace(size_t = 0, size_t = 0) {}
+inline void stopScopeTrace() {}
+inline void setTraceThreadName(const std::string &) {}
+inline bool writeScopeTrace(const std::string &) { return false; }
+
+#else // NO_SCOPE_PROFILING
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SCOPE_PROFILER_USE_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define SCOPE_PROFILER_USE_TSC 1
+#endif
+
+#include "../../Module4/18_IOStreams/TableFormatter.h"
+
+namespace scopeprofile
+{
+    constexpr int BUCKETS = 48; // bucket b holds durations below 2^b ticks
+    constexpr uint32_t NONE = 0xffffffffu;
+
+    inline uint64_t ticks()
+    {
+#ifdef SCOPE_PROFILER_USE_TSC
+        return __rdtsc();
+#else
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+#endif
+    }
+
+    inline int64_t steadyNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    struct Node
+    {
+        uint32_t label;
+        uint32_t parent;
+        uint32_t firstChild = NONE;
+        uint32_t nextSibling = NONE;
+        uint64_t count = 0;
+        uint64_t total = 0;
+        uint64_t min = UINT64_MAX;
+        uint64_t max = 0;
+        uint32_t histogram[BUCKETS] = {};
+
+        Node(uint32_t l, uint32_t p) : label(l), parent(p) {}
+
+        void add(uint64_t elapsed)
+        {
+            count++;
+            total += elapsed;
+            min = elapsed < min ? elapsed : min;
+            max = elapsed > max ? elapsed : max;
+            int b = elapsed == 0 ? 0 : 64 - __builtin_clzll(elapsed);
+            histogram[b < BUCKETS ? b : BUCKETS - 1]++;
+        }
+
+        void merge(const Node &other)
+        {
+            count += other.count;
+            total += other.total;
+            min = other.min < min ? other.min : min;
+            max = other.max > max ? other.max : max;
+            for (int b = 0; b < BUCKETS; b++)
+                histogram[b] += other.histogram[b];
+        }
+    };
+
+    // One entry of a thread's trace ring: a finished scope or a counter sample
+    struct TraceEvent
+    {
+        uint64_t start;
+        uint64_t duration; // scopes only
+        double value;      // counters only
+        uint32_t label;
+        bool counter;
+    };
+
+    // Node 0 is the root (the thread itself); `current` is the innermost open scope
+    class CallTree
+    {
+    public:
+        std::vector<Node> nodes;
+        uint32_t current = 0;
+        bool live;
+
+        // Tracing state; the ring is allocated on the first traced event
+        uint32_t threadId = 0;
+        std::string threadName;
+        std::vector<TraceEvent> trace;
+        uint64_t traceWritten = 0;
+        uint32_t traceSession = 0; // ring contents are stale unless this is the current session
+
+        void addTrace(const TraceEvent &event);
+
+        // Events oldest first (only the last trace.size() survive a wrap)
+        std::vector<TraceEvent> orderedTrace() const
+        {
+            std::vector<TraceEvent> events;
+            if (trace.empty())
+                return events;
+            size_t kept = traceWritten < trace.size() ? (size_t)traceWritten : trace.size();
+            size_t first = (size_t)(traceWritten - kept);
+            for (size_t i = 0; i < kept; i++)
+                events.push_back(trace[(first + i) & (trace.size() - 1)]);
+            return events;
+        }
+
+        explicit CallTree(bool registerThread = true);
+        ~CallTree();
+
+        // Returns the child of `parent` with this label, creating it if needed
+        uint32_t child(uint32_t parent, uint32_t label)
+        {
+            uint32_t previous = NONE;
+            for (uint32_t c = nodes[parent].firstChild; c != NONE; c = nodes[c].nextSibling)
+            {
+                if (nodes[c].label == label)
+                    return c;
+                previous = c;
+            }
+            uint32_t created = (uint32_t)nodes.size();
+            nodes.emplace_back(label, parent);
+            if (previous == NONE)
+                nodes[parent].firstChild = created;
+            else
+                nodes[previous].nextSibling = created;
+            return created;
+        }
+
+        // Adds another tree's statistics, matching nodes by their label path
+        void merge(const CallTree &other, uint32_t from = 0, uint32_t into = 0)
+        {
+            nodes[into].merge(other.nodes[from]);
+            for (uint32_t c = other.nodes[from].firstChild; c != NONE; c = other.nodes[c].nextSibling)
+            {
+                uint32_t target = child(into, other.nodes[c].label);
+                merge(other, c, target);
+            }
+        }
+    };
+
+    // Trace of a thread that has exited, kept until the trace is written
+    struct RetiredTrace
+    {
+        uint32_t threadId;
+        std::string threadName;
+        std::vector<TraceEvent> events;
+        uint64_t dropped;
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::string> labels;
+        std::vector<CallTree *> threads;
+        CallTree retired{false};
+        bool reportAtExit = true;
+
+        std::atomic<bool> tracing{false};
+        std::atomic<uint32_t> traceSession{0};
+        size_t traceCapacity = 1 << 16; // events per thread, a power of two
+        uint32_t nextThreadId = 1;
+        // Exited threads' events, oldest thread first, at most retiredEventLimit
+        // in total; evicted events are counted in retiredDropped
+        std::deque<RetiredTrace> retiredTraces;
+        size_t retiredEventLimit = 1 << 18;
+        size_t retiredEvents = 0;
+        uint64_t retiredDropped = 0;
+        // Calibration: ticks and steady_clock read at the same moment
+        uint64_t startTicks = ticks();
+        int64_t startNs = steadyNs();
+
+        static Registry &instance()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        uint32_t addLabel(const char *label)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < labels.size(); i++)
+                if (labels[i] == label)
+                    return (uint32_t)i;
+            labels.push_back(label);
+            return (uint32_t)labels.size() - 1;
+        }
+
+        double nsPerTick()
+        {
+            uint64_t elapsedTicks = ticks() - startTicks;
+            int64_t elapsedNs = steadyNs() - startNs;
+            return elapsedTicks == 0 ? 1.0 : (double)elapsedNs / (double)elapsedTicks;
+        }
+
+        void print(std::ostream &os);
+        bool writeTrace(const std::string &path);
+
+        // Caller holds mutex
+        void retireTrace(RetiredTrace trace)
+        {
+            if (trace.events.size() > retiredEventLimit)
+            {
+                size_t excess = trace.events.size() - retiredEventLimit;
+                trace.events.erase(trace.events.begin(), trace.events.begin() + (std::ptrdiff_t)excess);
+                trace.dropped += excess;
+            }
+            retiredEvents += trace.events.size();
+            retiredTraces.push_back(std::move(trace));
+            while (retiredEvents > retiredEventLimit)
+            {
+                RetiredTrace &oldest = retiredTraces.front();
+                retiredEvents -= oldest.events.size();
+                retiredDropped += oldest.events.size() + oldest.dropped;
+                retiredTraces.pop_front();
+            }
+        }
+
+        ~Registry()
+        {
+            if (reportAtExit)
+                print(std::cerr);
+        }
+
+    private:
+        Registry() = default;
+    };
+
+    inline CallTree::CallTree(bool registerThread) : live(registerThread)
+    {
+        nodes.reserve(64);
+        nodes.emplace_back(NONE, NONE);
+        if (!live)
+            return;
+        Registry &registry = Registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.push_back(this);
+        threadId = registry.nextThreadId++;
+    }
+
+    // A finished thread's tree is folded into Registry::retired
+    inline CallTree::~CallTree()
+    {
+        if (!live)
+            return;
+        Registry &registry = Registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.retired.merge(*this);
+        if (traceWritten > 0 && traceSession == registry.traceSession.load(std::memory_order_relaxed))
+            registry.retireTrace(RetiredTrace{threadId, threadName, orderedTrace(),
+                                              traceWritten - std::min<uint64_t>(traceWritten, trace.size())});
+        registry.threads.erase(std::remove(registry.threads.begin(), registry.threads.end(), this),
+                               registry.threads.end());
+    }
+
+    // The ring is (re)allocated on the first event of each session
+    inline void CallTree::addTrace(const TraceEvent &event)
+    {
+        Registry &registry = Registry::instance();
+        uint32_t session = registry.traceSession.load(std::memory_order_relaxed);
+        if (trace.empty() || traceSession != session)
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            std::vector<TraceEvent>(registry.traceCapacity).swap(trace);
+            traceWritten = 0;
+            traceSession = session;
+        }
+        trace[traceWritten & (trace.size() - 1)] = event;
+        traceWritten++;
+    }
+
+    inline void appendJsonString(std::string &out, const std::string &text)
+    {
+        out += '"';
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out += '\\';
+                out += c;
+            }
+            else if ((unsigned char)c < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)(unsigned char)c);
+                out += escaped;
+            }
+            else
+            {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+
+    // Chrome trace-event JSON: one "M" event naming each thread, then its
+    // "X" (complete) and "C" (counter) events. Timestamps are microseconds
+    // since the profiler started.
+    inline bool Registry::writeTrace(const std::string &path)
+    {
+        std::vector<RetiredTrace> all;
+        std::vector<std::string> names;
+        uint64_t dropped;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            all.assign(retiredTraces.begin(), retiredTraces.end());
+            dropped = retiredDropped;
+            uint32_t session = traceSession.load(std::memory_order_relaxed);
+            for (CallTree *tree : threads)
+            {
+                if (tree->traceWritten > 0 && tree->traceSession == session)
+                    all.push_back(RetiredTrace{tree->threadId, tree->threadName, tree->orderedTrace(),
+                                               tree->traceWritten - std::min<uint64_t>(tree->traceWritten, tree->trace.size())});
+            }
+            names = labels;
+        }
+
+        double usPerTick = nsPerTick() / 1000.0;
+        std::string json = "{\"traceEvents\":[\n";
+        bool first = true;
+        char number[160];
+        auto separator = [&]()
+        {
+            if (!first)
+                json += ",\n";
+            first = false;
+        };
+
+        for (const RetiredTrace &thread : all)
+        {
+            dropped += thread.dropped;
+            separator();
+            std::snprintf(number, sizeof(number), "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                          thread.threadId);
+            json += number;
+            appendJsonString(json, thread.threadName.empty() ? "thread " + std::to_string(thread.threadId) : thread.threadName);
+            json += "}}";
+
+            for (const TraceEvent &event : thread.events)
+            {
+                separator();
+                json += "{\"name\":";
+                appendJsonString(json, names[event.label]);
+                double ts = (double)(event.start - startTicks) * usPerTick;
+                if (event.counter)
+                    std::snprintf(number, sizeof(number), ",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%.17g}}",
+                                  ts, thread.threadId, event.value);
+                else
+                    std::snprintf(number, sizeof(number), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                                  ts, (double)event.duration * usPerTick, thread.threadId);
+                json += number;
+            }
+        }
+        json += "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedEvents\":";
+        json += std::to_string(dropped);
+        json += "}}\n";
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(json.data(), (std::streamsize)json.size());
+        return (bool)file;
+    }
+
+    // The tree's constructor finishes constructing the Registry first, so the
+    // Registry (and its exit report) outlives the main thread's tree
+    inline CallTree &threadTree()
+    {
+        thread_local CallTree tree;
+        return tree;
+    }
+
+    // Upper bound of the histogram bucket holding the given quantile, clamped
+    // to the observed [min, max] so it never reads above the true maximum
+    inline uint64_t percentileTicks(const Node &node, double quantile)
+    {
+        uint64_t target = (uint64_t)((double)node.count * quantile);
+        uint64_t seen = 0;
+        uint64_t bound = node.max;
+        for (int b = 0; b < BUCKETS; b++)
+        {
+            seen += node.histogram[b];
+            if (seen > target)
+            {
+                bound = b == 0 ? 0 : 1ULL << b;
+                break;
+            }
+        }
+        return std::min(std::max(bound, node.min), node.max);
+    }
+
+    inline void Registry::print(std::ostream &os)
+    {
+        CallTree total(false);
+        std::vector<std::string> names;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            total.merge(retired);
+            for (CallTree *tree : threads)
+                total.merge(*tree);
+            names = labels;
+        }
+        if (total.nodes.size() <= 1)
+            return;
+
+        double usPerTick = nsPerTick() / 1000.0;
+        auto addTimes = [&](TableFormatter &table, const Node &node)
+        {
+            table.cell((unsigned long long)node.count)
+                .cell((double)node.total * usPerTick / 1000.0)
+                .cell((double)node.total * usPerTick / (double)node.count)
+                .cell((double)node.min * usPerTick)
+                .cell((double)node.max * usPerTick)
+                .cell((double)percentileTicks(node, 0.99) * usPerTick);
+        };
+        auto addColumns = [](TableFormatter &table, const char *first)
+        {
+            table.addColumn(first)
+                .addColumn("Calls", TableFormatter::Right)
+                .addColumn("Total ms", TableFormatter::Right, 3)
+                .addColumn("Avg us", TableFormatter::Right, 3)
+                .addColumn("Min us", TableFormatter::Right, 3)
+                .addColumn("Max us", TableFormatter::Right, 3)
+                .addColumn("p99 us", TableFormatter::Right, 3);
+        };
+
+        // Call tree, depth first, children in order of first appearance
+        TableFormatter tree;
+        addColumns(tree, "Scope (inclusive time)");
+        std::vector<std::pair<uint32_t, int>> stack;
+        for (uint32_t c = total.nodes[0].firstChild; c != NONE; c = total.nodes[c].nextSibling)
+            stack.emplace_back(c, 0);
+        std::reverse(stack.begin(), stack.end());
+        while (!stack.empty())
+        {
+            uint32_t index = stack.back().first;
+            int depth = stack.back().second;
+            stack.pop_back();
+            const Node &node = total.nodes[index];
+            tree.cell(std::string((size_t)depth * 2, ' ') + names[node.label]);
+            addTimes(tree, node);
+            tree.endRow();
+
+            size_t mark = stack.size();
+            for (uint32_t c = node.firstChild; c != NONE; c = total.nodes[c].nextSibling)
+                stack.emplace_back(c, depth + 1);
+            std::reverse(stack.begin() + (long)mark, stack.end());
+        }
+
+        // Flat view: every node with the same label, wherever it was called from
+        std::vector<Node> flat;
+        for (size_t l = 0; l < names.size(); l++)
+            flat.emplace_back((uint32_t)l, NONE);
+        for (size_t i = 1; i < total.nodes.size(); i++)
+            flat[total.nodes[i].label].merge(total.nodes[i]);
+        std::sort(flat.begin(), flat.end(), [](const Node &a, const Node &b)
+                  { return a.total > b.total; });
+        TableFormatter byLabel;
+        addColumns(byLabel, "Label");
+        for (const Node &node : flat)
+        {
+            if (node.count == 0)
+                continue;
+            byLabel.cell(names[node.label]);
+            addTimes(byLabel, node);
+            byLabel.endRow();
+        }
+
+        os << "\n== Scope profile: call tree ==\n";
+        tree.print(os);
+        os << "\n== Scope profile: by label (p99 = histogram bucket upper bound, capped at max) ==\n";
+        byLabel.print(os);
+        os.flush();
+    }
+} // namespace scopeprofile
+
+// RAII scope: enter() on construction, time recorded on destruction
+class ProfileScope
+{
+    scopeprofile::CallTree &tree;
+    uint32_t node;
+    uint64_t start;
+
+public:
+    explicit ProfileScope(uint32_t label)
+        : tree(scopeprofile::threadTree()), node(tree.child(tree.current, label))
+    {
+        tree.current = node;
+        start = scopeprofile::ticks();
+    }
+
+    ~ProfileScope()
+    {
+        uint64_t end = scopeprofile::ticks();
+        scopeprofile::Node &entry = tree.nodes[node];
+        entry.add(end - start);
+        tree.current = entry.parent;
+        if (scopeprofile::Registry::instance().tracing.load(std::memory_order_relaxed))
+            tree.addTrace(scopeprofile::TraceEvent{start, end - start, 0.0, entry.label, false});
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+inline uint32_t registerProfileLabel(const char *label)
+{
+    return scopeprofile::Registry::instance().addLabel(label);
+}
+
+#define SCOPE_PROFILER_CONCAT2(a, b) a##b
+#define SCOPE_PROFILER_CONCAT(a, b) SCOPE_PROFILER_CONCAT2(a, b)
+#define PROFILE_SCOPE(label)                                                                                   \
+    static const uint32_t SCOPE_PROFILER_CONCAT(profileLabel_, __LINE__) = registerProfileLabel(label); \
+    ProfileScope SCOPE_PROFILER_CONCAT(profileScope_, __LINE__)(SCOPE_PROFILER_CONCAT(profileLabel_, __LINE__))
+
+// Records a counter sample (a separate graph per name in the trace viewer)
+inline void traceCounter(uint32_t label, double value)
+{
+    if (!scopeprofile::Registry::instance().tracing.load(std::memory_order_relaxed))
+        return;
+    scopeprofile::threadTree().addTrace(scopeprofile::TraceEvent{scopeprofile::ticks(), 0, value, label, true});
+}
+
+#define TRACE_COUNTER(name, value)                                                                  \
+    do                                                                                              \
+    {                                                                                               \
+        static const uint32_t SCOPE_PROFILER_CONCAT(counterLabel_, __LINE__) = registerProfileLabel(name); \
+        traceCounter(SCOPE_PROFILER_CONCAT(counterLabel_, __LINE__), (double)(value));             \
+    } while (0)
+
+// Prints the merged report now (it is printed to stderr at exit as well,
+// unless turned off with setScopeProfileReportAtExit(false))
+inline void printScopeProfile(std::ostream &os)
+{
+    scopeprofile::Registry::instance().print(os);
+}
+
+inline void setScopeProfileReportAtExit(bool enabled)
+{
+    scopeprofile::Registry &registry = scopeprofile::Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.reportAtExit = enabled;
+}
+
+// Starts a new trace session, discarding events of any earlier one.
+// eventsPerThread is rounded up to a power of two; exitedThreadEvents caps
+// what exited threads keep in total until the trace is written.
+inline void startScopeTrace(size_t eventsPerThread = 1 << 16, size_t exitedThreadEvents = 1 << 18)
+{
+    scopeprofile::Registry &registry = scopeprofile::Registry::instance();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        size_t capacity = 2;
+        while (capacity < eventsPerThread)
+            capacity <<= 1;
+        registry.traceCapacity = capacity;
+        registry.retiredEventLimit = exitedThreadEvents;
+        std::deque<scopeprofile::RetiredTrace>().swap(registry.retiredTraces);
+        registry.retiredEvents = 0;
+        registry.retiredDropped = 0;
+        registry.traceSession.fetch_add(1); // live rings reset on their next event
+    }
+    registry.tracing.store(true);
+}
+
+inline void stopScopeTrace()
+{
+    scopeprofile::Registry::instance().tracing.store(false);
+}
+
+// Name shown for the calling thread's track in the trace viewer
+inline void setTraceThreadName(const std::string &name)
+{
+    scopeprofile::threadTree().threadName = name;
+}
+
+// Writes every thread's ring (including exited threads) as Chrome trace JSON.
+// Like printScopeProfile(), call it while no other thread is recording.
+inline bool writeScopeTrace(const std::string &path)
+{
+    return scopeprofile::Registry::instance().writeTrace(path);
+}
+
+#endif // NO_SCOPE_PROFILING
+
+#endif // SCOPE_PROFILER_H
@@ -3,9 +3,10 @@
 // Note: In a real project, these sections are separate physical files.
 
 // ===== networkconnection.h (public interface) =====
-#include <memory>
 #include <string>
 
+#include "FastPimpl.h"
+
 class NetworkConnection
 {
 public:
@@ -22,7 +23,9 @@ public:
 
 private:
     struct Impl;
-    std::unique_ptr<Impl> impl;
+    // Inline Impl storage (see FastPimpl.h); size/alignment for 64-bit targets.
+    // A moved-from connection holds an Impl that is no longer connected.
+    FastPimpl<Impl, 40, 8> impl;
 };
 
 // ===== networkconnection.cpp (implementation) =====
@@ -42,12 +45,36 @@ struct NetworkConnection::Impl
         std::cout << "[Impl] Connected to " << endpoint << std::endl;
     }
 
+    // Ownership of the open connection moves; the source is left disconnected
+    Impl(Impl &&other) noexcept : endpoint(std::move(other.endpoint)), connected(other.connected)
+    {
+        other.connected = false;
+    }
+
+    Impl &operator=(Impl &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            endpoint = std::move(other.endpoint);
+            connected = other.connected;
+            other.connected = false;
+        }
+        return *this;
+    }
+
     ~Impl()
     {
         // RAII release: close connection in destructor.
+        close();
+    }
+
+    void close()
+    {
         if (connected)
         {
             std::cout << "[Impl] Connection to " << endpoint << " closed" << std::endl;
+            connected = false;
         }
     }
 
@@ -64,39 +91,23 @@ struct NetworkConnection::Impl
 };
 
 NetworkConnection::NetworkConnection(const std::string &endpoint)
-    : impl(std::make_unique<Impl>(endpoint))
+    : impl(endpoint)
 {
 }
 
 NetworkConnection::~NetworkConnection() = default;
 
-NetworkConnection::NetworkConnection(NetworkConnection &&other) noexcept
-    : impl(std::move(other.impl))
-{
-}
-
-NetworkConnection &NetworkConnection::operator=(NetworkConnection &&other) noexcept
-{
-    if (this != &other)
-    {
-        impl = std::move(other.impl);
-    }
-    return *this;
-}
+NetworkConnection::NetworkConnection(NetworkConnection &&other) noexcept = default;
+NetworkConnection &NetworkConnection::operator=(NetworkConnection &&other) noexcept = default;
 
 bool NetworkConnection::isConnected() const
 {
-    return impl && impl->connected;
+    return impl->connected;
 }
 
 void NetworkConnection::sendData(const std::string &data)
 {
-    if (!impl)
-    {
-        std::cerr << "[Impl] Not connected!" << std::endl;
-        return;
-    }
-
+    // A moved-from connection reports "Not connected!" from Impl::sendData
     impl->sendData(data);
 }
 
@@ -112,6 +123,11 @@ int main()
 
         std::cout << "conn1 connected? " << (conn1.isConnected() ? "yes" : "no") << std::endl;
         std::cout << "conn2 connected? " << (conn2.isConnected() ? "yes" : "no") << std::endl;
+
+        // Moving transfers the open connection; it is still closed exactly once
+        NetworkConnection conn3(std::move(conn1));
+        std::cout << "after move: conn1 connected? " << (conn1.isConnected() ? "yes" : "no")
+                  << ", conn3 connected? " << (conn3.isConnected() ? "yes" : "no") << std::endl;
     } // Connections are closed automatically at scope exit.
 
     std::cout << "All connections closed (destructor)." << std::endl;
@@ -0,0 +1,162 @@
+// Task11WorkStealingThreadPool.cpp
+// A shared work-stealing thread pool (WorkStealingPool.h): futures, parallel
+// loops and reductions, nested tasks, exception propagation and shutdown.
+// Task4 creates raw std::threads for every run; here a fixed set of workers
+// is reused and load-balanced by stealing.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "WorkStealingPool.h"
+
+// Parallel merge sort built on TaskGroup: each split sorts its left half
+// itself and hands the right half to the pool, so recursion nests naturally.
+void parallelSort(WorkStealingPool &pool, std::vector<int> &data, size_t lo, size_t hi, std::vector<int> &scratch)
+{
+    const size_t serialCutoff = 1 << 14;
+    if (hi - lo <= serialCutoff)
+    {
+        std::sort(data.begin() + lo, data.begin() + hi);
+        return;
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    TaskGroup group(pool);
+    group.run([&pool, &data, &scratch, mid, hi]()
+              { parallelSort(pool, data, mid, hi, scratch); });
+    parallelSort(pool, data, lo, mid, scratch);
+    group.wait();
+
+    std::merge(data.begin() + lo, data.begin() + mid, data.begin() + mid, data.begin() + hi, scratch.begin() + lo);
+    std::copy(scratch.begin() + lo, scratch.begin() + hi, data.begin() + lo);
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    size_t threads = argc > 1 ? (size_t)std::stoul(argv[1]) : std::thread::hardware_concurrency();
+    WorkStealingPool pool(threads);
+    std::cout << "== Work-Stealing Thread Pool (" << pool.size() << " workers) ==" << std::endl;
+
+    // 1. submit() returns a std::future
+    std::future<long long> answer = pool.submit([]()
+                                                {
+        long long sum = 0;
+        for (int i = 1; i <= 1000; ++i)
+        {
+            sum += (long long)i * i;
+        }
+        return sum; });
+    std::cout << "Sum of squares 1..1000: " << answer.get() << std::endl;
+
+    // 2. Exceptions thrown by a task come back through its future
+    std::future<int> failing = pool.submit([]() -> int
+                                           { throw std::runtime_error("task failed on purpose"); });
+    try
+    {
+        failing.get();
+    }
+    catch (const std::exception &ex)
+    {
+        std::cout << "Exception from future: " << ex.what() << std::endl;
+    }
+
+    // 3. parallelFor and parallelReduce compared with plain loops
+    const size_t n = 20000000;
+    std::vector<double> values(n);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i)
+    {
+        values[i] = std::sqrt((double)i);
+    }
+    double serialFor = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    pool.parallelFor((size_t)0, n, [&](size_t i)
+                     { values[i] = std::sqrt((double)i); });
+    double poolFor = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    double serialSum = std::accumulate(values.begin(), values.end(), 0.0);
+    double serialReduce = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    double poolSum = pool.parallelReduce(
+        (size_t)0, n, 0.0, [&](size_t i)
+        { return values[i]; },
+        [](double a, double b)
+        { return a + b; });
+    double poolReduce = secondsSince(start);
+
+    std::cout << "parallelFor    : " << poolFor << " s (serial " << serialFor << " s)" << std::endl;
+    std::cout << "parallelReduce : " << poolReduce << " s (serial " << serialReduce << " s), sums "
+              << (std::fabs(poolSum - serialSum) < 1e-6 * serialSum ? "match" : "DIFFER") << std::endl;
+
+    // 4. Nested tasks: a recursive parallel merge sort
+    std::vector<int> data(4000000);
+    std::mt19937 random(42);
+    for (int &x : data)
+    {
+        x = (int)random();
+    }
+    std::vector<int> expected = data;
+    std::vector<int> scratch(data.size());
+
+    start = std::chrono::steady_clock::now();
+    std::sort(expected.begin(), expected.end());
+    double serialSort = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    parallelSort(pool, data, 0, data.size(), scratch);
+    double poolSort = secondsSince(start);
+    std::cout << "parallelSort   : " << poolSort << " s (std::sort " << serialSort << " s), result "
+              << (data == expected ? "correct" : "WRONG") << std::endl;
+
+    // 5. An exception inside parallelFor stops the loop and reaches the caller
+    try
+    {
+        pool.parallelFor(0, 1000000, [](int i)
+                         {
+            if (i == 123456)
+            {
+                throw std::out_of_range("bad element " + std::to_string(i));
+            } });
+    }
+    catch (const std::exception &ex)
+    {
+        std::cout << "Exception from parallelFor: " << ex.what() << std::endl;
+    }
+
+    // 6. Shutdown: queued work finishes, then the workers are joined
+    std::atomic<int> finished{0};
+    for (int i = 0; i < 100; ++i)
+    {
+        pool.post([&finished]()
+                  { finished.fetch_add(1); });
+    }
+    pool.shutdown();
+    std::cout << "Tasks finished before shutdown completed: " << finished.load() << " / 100" << std::endl;
+
+    // Workers are gone, so a late task is refused rather than left queued forever
+    try
+    {
+        pool.submit([]()
+                    { return 0; });
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cout << "Submit after shutdown: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
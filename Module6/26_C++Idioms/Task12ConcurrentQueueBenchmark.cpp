@@ -0,0 +1,255 @@
+// Task12ConcurrentQueueBenchmark.cpp
+// Producer/consumer hand-off through the lock-free queues in ConcurrentQueue.h
+// compared with the obvious baseline, a std::deque guarded by a std::mutex.
+// Every message carries the time it was created, so the consumers measure
+// end-to-end latency as well as throughput.
+//
+// Usage: Task12ConcurrentQueueBenchmark [messagesPerProducer]
+// Latency percentiles depend heavily on the number of cores: with fewer cores
+// than threads, a message waits for the consumer to be scheduled again.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../Module4/18_IOStreams/TableFormatter.h"
+#include "ConcurrentQueue.h"
+
+struct Message
+{
+    uint64_t value = 0;
+    int64_t createdNs = 0;
+};
+
+// Baseline with the same bounded try-interface as the lock-free queues
+class MutexDequeQueue
+{
+    std::mutex mutex;
+    std::deque<Message> items;
+    size_t limit;
+
+public:
+    explicit MutexDequeQueue(size_t capacity) : limit(capacity) {}
+
+    bool tryPush(const Message &message)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.size() >= limit)
+            return false;
+        items.push_back(message);
+        return true;
+    }
+
+    bool tryPop(Message &out)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty())
+            return false;
+        out = items.front();
+        items.pop_front();
+        return true;
+    }
+
+    template <typename It>
+    size_t tryPushBatch(It first, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t n = std::min(count, limit - items.size());
+        items.insert(items.end(), first, first + n);
+        return n;
+    }
+
+    template <typename It>
+    size_t tryPopBatch(It out, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t n = std::min(count, items.size());
+        std::copy(items.begin(), items.begin() + n, out);
+        items.erase(items.begin(), items.begin() + n);
+        return n;
+    }
+};
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+struct RunResult
+{
+    double millionsPerSecond = 0;
+    double p50Us = 0;
+    double p99Us = 0;
+    double p999Us = 0;
+    double maxUs = 0;
+    bool correct = false;
+};
+
+// Runs `producers` x `consumers` threads moving perProducer messages each.
+// batch == 1 uses tryPush/tryPop, larger values the batch operations.
+template <typename Queue>
+RunResult runQueue(Queue &queue, int producers, int consumers, long long perProducer, size_t batch)
+{
+    const long long total = perProducer * producers;
+    std::atomic<long long> consumed{0};
+    std::atomic<uint64_t> checksum{0};
+    std::vector<std::vector<int64_t>> latencies(consumers);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&queue, p, perProducer, batch]()
+                             {
+            std::vector<Message> pending(batch);
+            QueueBackoff backoff;
+            long long i = 0;
+            while (i < perProducer)
+            {
+                size_t n = (size_t)std::min<long long>((long long)batch, perProducer - i);
+                int64_t stamp = nowNs();
+                for (size_t k = 0; k < n; k++)
+                    pending[k] = Message{(uint64_t)(p * perProducer + i + (long long)k), stamp};
+                size_t sent = 0;
+                while (sent < n)
+                {
+                    size_t got = batch == 1 ? (queue.tryPush(pending[0]) ? 1 : 0)
+                                            : queue.tryPushBatch(pending.begin() + sent, n - sent);
+                    if (got == 0)
+                        backoff.pause();
+                    sent += got;
+                }
+                i += (long long)n;
+            } });
+    }
+    for (int c = 0; c < consumers; c++)
+    {
+        threads.emplace_back([&, c]()
+                             {
+            std::vector<int64_t> &samples = latencies[c];
+            samples.reserve((size_t)(total / consumers + batch));
+            std::vector<Message> received(batch);
+            QueueBackoff backoff;
+            uint64_t sum = 0;
+            while (consumed.load(std::memory_order_relaxed) < total)
+            {
+                size_t got = batch == 1 ? (queue.tryPop(received[0]) ? 1 : 0)
+                                        : queue.tryPopBatch(received.begin(), batch);
+                if (got == 0)
+                {
+                    backoff.pause();
+                    continue;
+                }
+                int64_t now = nowNs();
+                for (size_t k = 0; k < got; k++)
+                {
+                    sum += received[k].value;
+                    samples.push_back(now - received[k].createdNs);
+                }
+                consumed.fetch_add((long long)got, std::memory_order_relaxed);
+            }
+            checksum.fetch_add(sum); });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<int64_t> all;
+    all.reserve((size_t)total);
+    for (const std::vector<int64_t> &samples : latencies)
+        all.insert(all.end(), samples.begin(), samples.end());
+    auto percentile = [&all](double fraction)
+    {
+        if (all.empty())
+            return 0.0;
+        size_t index = std::min(all.size() - 1, (size_t)(fraction * (double)all.size()));
+        std::nth_element(all.begin(), all.begin() + index, all.end());
+        return (double)all[index] / 1000.0;
+    };
+
+    RunResult result;
+    uint64_t n = (uint64_t)total;
+    result.correct = consumed.load() == total && checksum.load() == n * (n - 1) / 2;
+    result.millionsPerSecond = (double)total / seconds / 1e6;
+    result.p50Us = percentile(0.50);
+    result.p99Us = percentile(0.99);
+    result.p999Us = percentile(0.999);
+    result.maxUs = all.empty() ? 0.0 : (double)*std::max_element(all.begin(), all.end()) / 1000.0;
+    return result;
+}
+
+void addRow(TableFormatter &table, const std::string &name, int producers, int consumers, size_t batch, const RunResult &r)
+{
+    table.cell(name)
+        .cell(std::to_string(producers) + "P/" + std::to_string(consumers) + "C")
+        .cell((long long)batch)
+        .cell(r.millionsPerSecond)
+        .cell(r.p50Us)
+        .cell(r.p99Us)
+        .cell(r.p999Us)
+        .cell(r.maxUs)
+        .cell(r.correct ? "ok" : "WRONG")
+        .endRow();
+}
+
+int main(int argc, char *argv[])
+{
+    long long perProducer = argc > 1 ? std::atoll(argv[1]) : 1000000;
+    if (perProducer <= 0)
+    {
+        std::cerr << "Usage: " << argv[0] << " [messages per producer > 0]\n";
+        return 1;
+    }
+    const size_t capacity = 4096;
+
+    std::cout << "== Concurrent queue benchmark: " << perProducer << " messages per producer, capacity "
+              << capacity << ", " << std::thread::hardware_concurrency() << " hardware threads ==\n\n";
+
+    TableFormatter table;
+    table.addColumn("Queue")
+        .addColumn("Threads")
+        .addColumn("Batch", TableFormatter::Right)
+        .addColumn("M msg/s", TableFormatter::Right, 2)
+        .addColumn("p50 us", TableFormatter::Right, 1)
+        .addColumn("p99 us", TableFormatter::Right, 1)
+        .addColumn("p99.9 us", TableFormatter::Right, 1)
+        .addColumn("max us", TableFormatter::Right, 0)
+        .addColumn("Check");
+
+    const int configs[][2] = {{1, 1}, {2, 2}, {4, 4}};
+    for (size_t batch : {(size_t)1, (size_t)32})
+    {
+        for (const auto &config : configs)
+        {
+            int producers = config[0];
+            int consumers = config[1];
+            {
+                MutexDequeQueue queue(capacity);
+                addRow(table, "mutex+deque", producers, consumers, batch, runQueue(queue, producers, consumers, perProducer, batch));
+            }
+            {
+                MPMCQueue<Message> queue(capacity);
+                addRow(table, "MPMCQueue", producers, consumers, batch, runQueue(queue, producers, consumers, perProducer, batch));
+            }
+            if (producers == 1 && consumers == 1)
+            {
+                SPSCQueue<Message> queue(capacity);
+                addRow(table, "SPSCQueue", producers, consumers, batch, runQueue(queue, producers, consumers, perProducer, batch));
+            }
+        }
+    }
+
+    table.print(std::cout);
+    std::cout << "\nLatency is measured from message creation to consumption; with batching it\n"
+                 "includes the time a message waits for its batch to be filled or drained.\n";
+    return 0;
+}
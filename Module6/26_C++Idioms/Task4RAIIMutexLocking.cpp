@@ -1,21 +1,283 @@
 // Task4RAIIMutexLocking.cpp
 // RAII for mutex locking with std::lock_guard: exception-safe synchronization.
+//
+// The global mutex counter is correct but every increment serializes all
+// threads on one lock and one cache line, so throughput drops as threads are
+// added. The counters further down avoid that contention:
+//   - PaddedSlotCounter : one cache-line-sized slot per thread, summed on read
+//   - StripedCounter    : a few padded atomics; threads spread across them
+//   - BatchedCounter    : each thread counts locally and flushes periodically
+// Each one hands out a per-thread Handle, and the batched Handle flushes in
+// its destructor (RAII), so an exception keeps the increments made before it
+// exactly like the lock_guard version. Run with --bench for a 1..64 thread
+// scaling comparison.
+//
+// The global mutex is a ProfiledMutex. Build with -DLOCK_PROFILING to get a
+// wait/hold/contention report per lock site at the end of the run; without
+// the flag it is an ordinary std::mutex.
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <exception>
 #include <iostream>
 #include <mutex>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
 
+#include "ProfiledMutex.h"
+
 int counter = 0;
-std::mutex mtx;
+ProfiledMutex mtx("counter mutex");
+
+// Cache line size used for padding; 64 bytes on current x86 and most ARM cores
+constexpr size_t CACHE_LINE = 64;
+
+// Wraps the original global counter in the same Handle interface as the others
+struct MutexCounter
+{
+    struct Handle
+    {
+        void add(long long n)
+        {
+            std::lock_guard<ProfiledMutex> lock(mtx);
+            counter += static_cast<int>(n);
+        }
+    };
+
+    Handle handle(size_t) { return Handle(); }
+    long long read() const
+    {
+        std::lock_guard<ProfiledMutex> lock(mtx);
+        return counter;
+    }
+    void reset() { counter = 0; }
+};
+
+// One padded slot per thread. Each slot has a single writer, so add() is a
+// plain relaxed load + store instead of a locked read-modify-write.
+// read() sums all slots and may miss increments that are still in flight.
+class PaddedSlotCounter
+{
+    struct alignas(CACHE_LINE) Slot
+    {
+        std::atomic<long long> value{0};
+    };
+    std::vector<Slot> slots;
+
+public:
+    explicit PaddedSlotCounter(size_t threads) : slots(threads) {}
+
+    class Handle
+    {
+        std::atomic<long long> *slot;
+
+    public:
+        explicit Handle(std::atomic<long long> *s) : slot(s) {}
+        void add(long long n)
+        {
+            slot->store(slot->load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    };
+
+    Handle handle(size_t threadIndex) { return Handle(&slots[threadIndex].value); }
+
+    long long read() const
+    {
+        long long total = 0;
+        for (const Slot &slot : slots)
+        {
+            total += slot.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void reset()
+    {
+        for (Slot &slot : slots)
+        {
+            slot.value.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// A fixed number of padded atomics. Works for any number of threads (no
+// registration needed); threads sharing a stripe still contend, but far less
+// than on one global counter.
+class StripedCounter
+{
+    static constexpr size_t STRIPES = 16;
+    struct alignas(CACHE_LINE) Stripe
+    {
+        std::atomic<long long> value{0};
+    };
+    Stripe stripes[STRIPES];
+
+public:
+    class Handle
+    {
+        std::atomic<long long> *stripe;
+
+    public:
+        explicit Handle(std::atomic<long long> *s) : stripe(s) {}
+        void add(long long n) { stripe->fetch_add(n, std::memory_order_relaxed); }
+    };
+
+    Handle handle(size_t threadIndex) { return Handle(&stripes[threadIndex % STRIPES].value); }
+
+    long long read() const
+    {
+        long long total = 0;
+        for (const Stripe &stripe : stripes)
+        {
+            total += stripe.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void reset()
+    {
+        for (Stripe &stripe : stripes)
+        {
+            stripe.value.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Threads count in a local variable and publish to one shared atomic every
+// flushEvery increments. read() lags by at most threads * flushEvery until the
+// handles are destroyed.
+class BatchedCounter
+{
+    std::atomic<long long> total{0};
+    int flushEvery;
+
+public:
+    explicit BatchedCounter(int batch = 1024) : flushEvery(batch) {}
+
+    // RAII: whatever is still pending is published when the handle goes out of
+    // scope, including during stack unwinding after an exception
+    class Handle
+    {
+        BatchedCounter *owner;
+        long long pending = 0;
+        int untilFlush;
+
+    public:
+        explicit Handle(BatchedCounter *c) : owner(c), untilFlush(c->flushEvery) {}
+        Handle(Handle &&other) noexcept : owner(other.owner), pending(other.pending), untilFlush(other.untilFlush)
+        {
+            other.pending = 0;
+        }
+        Handle(const Handle &) = delete;
+        Handle &operator=(const Handle &) = delete;
+        ~Handle() { flush(); }
+
+        void add(long long n)
+        {
+            pending += n;
+            if (--untilFlush == 0)
+            {
+                flush();
+            }
+        }
+
+        void flush()
+        {
+            if (pending != 0)
+            {
+                owner->total.fetch_add(pending, std::memory_order_relaxed);
+                pending = 0;
+            }
+            untilFlush = owner->flushEvery;
+        }
+    };
+
+    Handle handle(size_t) { return Handle(this); }
+    long long read() const { return total.load(std::memory_order_relaxed); }
+    void reset() { total.store(0, std::memory_order_relaxed); }
+};
+
+// Same loop as safeIncrement, but through a counter Handle. The Handle lives
+// in this scope, so it is cleaned up however the loop exits.
+template <typename Counter>
+void countingWorker(Counter &shared, size_t threadIndex, int iterations, bool simulateException)
+{
+    try
+    {
+        auto local = shared.handle(threadIndex);
+        for (int i = 0; i < iterations; ++i)
+        {
+            if (simulateException && i == 42)
+            {
+                throw std::runtime_error("Simulated failure while counting");
+            }
+            local.add(1);
+        }
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Thread caught exception: " << ex.what() << std::endl;
+    }
+}
+
+// Runs `threads` workers on one counter and returns the elapsed seconds.
+// If throwingThread is set, thread 0 throws part-way through.
+template <typename Counter>
+double runCounter(Counter &shared, int threads, int iterations, bool throwingThread)
+{
+    shared.reset();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> group;
+    for (int i = 0; i < threads; ++i)
+    {
+        group.emplace_back([&shared, i, iterations, throwingThread]()
+                           { countingWorker(shared, (size_t)i, iterations, throwingThread && i == 0); });
+    }
+    for (auto &t : group)
+    {
+        t.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Throughput in millions of increments per second for 1..64 threads
+void runScalingBenchmark(int iterationsPerThread)
+{
+    MutexCounter mutexCounter;
+    PaddedSlotCounter slotCounter(64);
+    StripedCounter stripedCounter;
+    BatchedCounter batchedCounter;
+
+    std::cout << "\n== Scaling benchmark (" << iterationsPerThread << " increments per thread, M increments/s) ==\n";
+    std::printf("%8s %12s %12s %12s %12s\n", "threads", "lock_guard", "slots", "striped", "batched");
+    for (int threads = 1; threads <= 64; threads *= 2)
+    {
+        double total = (double)threads * iterationsPerThread / 1e6;
+        double mutexRate = total / runCounter(mutexCounter, threads, iterationsPerThread, false);
+        double slotRate = total / runCounter(slotCounter, threads, iterationsPerThread, false);
+        double stripedRate = total / runCounter(stripedCounter, threads, iterationsPerThread, false);
+        double batchedRate = total / runCounter(batchedCounter, threads, iterationsPerThread, false);
+        std::printf("%8d %12.1f %12.1f %12.1f %12.1f\n", threads, mutexRate, slotRate, stripedRate, batchedRate);
+
+        long long expected = (long long)threads * iterationsPerThread;
+        if (mutexCounter.read() != expected || slotCounter.read() != expected ||
+            stripedCounter.read() != expected || batchedCounter.read() != expected)
+        {
+            std::cout << "Error: a counter lost increments\n";
+        }
+    }
+}
 
 void safeIncrement(int iterations, bool simulateException)
 {
     for (int i = 0; i < iterations; ++i)
     {
         // lock_guard acquires the mutex now and guarantees unlock at scope exit.
-        std::lock_guard<std::mutex> lock(mtx);
+        // PROFILED_LOCK_GUARD is a std::lock_guard that, in profiling builds,
+        // reports this line separately from the other users of mtx.
+        PROFILED_LOCK_GUARD(lock, mtx);
 
         if (simulateException && i == 42)
         {
@@ -39,7 +301,7 @@ void worker(int iterations, bool simulateException)
     }
 }
 
-int main()
+int main(int argc, char *argv[])
 {
     const int threads = 4;
     const int iterations = 10000;
@@ -81,5 +343,31 @@ int main()
     std::cout << "Final counter value (with simulated exception): " << counter << std::endl;
     std::cout << "No deadlock observed. Mutex was released automatically via RAII." << std::endl;
 
+    // The contention-free counters keep the same guarantee: the throwing
+    // thread's first 42 increments are kept and nothing is left locked.
+    std::cout << "\n== Contention-free counters (one thread throws at i == 42) ==" << std::endl;
+    const long long expectedWithThrow = (long long)(threads - 1) * iterations + 42;
+
+    PaddedSlotCounter slotCounter(threads);
+    runCounter(slotCounter, threads, iterations, true);
+    std::cout << "Padded slots  : " << slotCounter.read() << std::endl;
+
+    StripedCounter stripedCounter;
+    runCounter(stripedCounter, threads, iterations, true);
+    std::cout << "Striped       : " << stripedCounter.read() << std::endl;
+
+    BatchedCounter batchedCounter;
+    runCounter(batchedCounter, threads, iterations, true);
+    std::cout << "Batched       : " << batchedCounter.read() << std::endl;
+    std::cout << "Expected value: " << expectedWithThrow << std::endl;
+
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+    {
+        runScalingBenchmark(argc > 2 ? std::stoi(argv[2]) : 1000000);
+    }
+
+    std::cout << std::endl;
+    printLockProfile(std::cout);
+
     return 0;
 }
@@ -3,31 +3,56 @@
 // Note: In a real project, these sections are separate physical files.
 
 // ===== widget.h (interface) =====
+#include <cstddef>
 #include <memory>
 #include <string>
 
+#include "FastPimpl.h"
+
 // PIMPL keeps implementation details out of the public interface.
 // Benefits: better encapsulation, fewer compile-time dependencies, and ABI stability.
 // Real-world use: shared libraries/SDKs expose stable headers while internals evolve.
 // Client code includes only this interface and does not depend on private member layout.
+//
+// Widget uses the "fast PIMPL" variant: Impl lives in aligned storage inside
+// the Widget instead of on the heap, so creating a Widget allocates nothing.
+// The header still only forward-declares Impl; it just has to state its size.
 class Widget
 {
 public:
     Widget();
     ~Widget();
 
-    // Rule-of-5 intent for a unique_ptr-owned implementation object.
+    // Rule-of-5 intent. The moves are defined in widget.cpp, where Impl is complete.
     Widget(const Widget &) = delete;
     Widget &operator=(const Widget &) = delete;
-    Widget(Widget &&) noexcept = default;
-    Widget &operator=(Widget &&) noexcept = default;
+    Widget(Widget &&) noexcept;
+    Widget &operator=(Widget &&) noexcept;
 
     void setName(const std::string &name);
     void printName() const;
 
 private:
-    struct Impl;                // Forward declaration
-    std::unique_ptr<Impl> impl; // PIMPL pointer
+    struct Impl; // Forward declaration
+    // sizeof/alignof(Impl) with 64-bit libstdc++/libc++; a mismatch is a compile error
+    static constexpr std::size_t ImplSize = 40;
+    static constexpr std::size_t ImplAlign = 8;
+    FastPimpl<Impl, ImplSize, ImplAlign> impl; // Inline PIMPL storage
+};
+
+// The classic heap-allocated PIMPL, kept for the --bench comparison
+class HeapWidget
+{
+public:
+    HeapWidget();
+    ~HeapWidget();
+    HeapWidget(HeapWidget &&) noexcept = default;
+    HeapWidget &operator=(HeapWidget &&) noexcept = default;
+    void setName(const std::string &name);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
 };
 
 // ===== widget.cpp (implementation) =====
@@ -44,12 +69,13 @@ struct Widget::Impl
     int internalRevision = 1;
 };
 
-Widget::Widget() : impl(std::make_unique<Impl>())
-{
-}
+Widget::Widget() = default; // Impl is constructed in place by FastPimpl
 
 Widget::~Widget() = default;
 
+Widget::Widget(Widget &&) noexcept = default;
+Widget &Widget::operator=(Widget &&) noexcept = default;
+
 void Widget::setName(const std::string &name)
 {
     // Only implementation code knows the concrete data layout.
@@ -61,8 +87,64 @@ void Widget::printName() const
     std::cout << "Widget name: " << impl->name << std::endl;
 }
 
+struct HeapWidget::Impl
+{
+    std::string name;
+    int internalRevision = 1;
+};
+
+HeapWidget::HeapWidget() : impl(std::make_unique<Impl>())
+{
+}
+
+HeapWidget::~HeapWidget() = default;
+
+void HeapWidget::setName(const std::string &name)
+{
+    impl->name = name;
+}
+
 // ===== main.cpp (demo) =====
-int main()
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+// Counts every heap allocation in the program, for the --bench comparison
+static std::size_t allocationCount = 0;
+
+void *operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// Creates `count` widgets in a pre-reserved vector, names them, destroys them
+template <typename W>
+void benchmarkWidgets(const char *label, std::size_t count)
+{
+    std::vector<W> widgets;
+    widgets.reserve(count);
+    std::size_t allocationsBefore = allocationCount;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        widgets.emplace_back();
+        widgets.back().setName("w");
+    }
+    widgets.clear();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << label << ": " << count << " widgets in " << ms << " ms, "
+              << (allocationCount - allocationsBefore) << " heap allocations" << std::endl;
+}
+
+int main(int argc, char *argv[])
 {
     // Users interact only with Widget's public API.
     // They do not see Impl and are unaffected by private implementation refactors.
@@ -71,5 +153,12 @@ int main()
     w.printName();
 
     // If internalRevision or other Impl internals change, this usage code stays the same.
+
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+    {
+        std::size_t count = argc > 2 ? std::stoul(argv[2]) : 2000000;
+        benchmarkWidgets<HeapWidget>("unique_ptr PIMPL", count);
+        benchmarkWidgets<Widget>("FastPimpl       ", count);
+    }
     return 0;
 }
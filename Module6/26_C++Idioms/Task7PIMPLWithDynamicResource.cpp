@@ -3,9 +3,11 @@
 // Note: In a real project, these sections are separate physical files.
 
 // ===== Widget.h (interface) =====
-#include <memory>
+#include <cstddef>
 #include <string>
 
+#include "FastPimpl.h"
+
 class Widget
 {
 public:
@@ -14,20 +16,23 @@ public:
 
     Widget(const Widget &) = delete;
     Widget &operator=(const Widget &) = delete;
-    Widget(Widget &&) noexcept = default;
-    Widget &operator=(Widget &&) noexcept = default;
+    Widget(Widget &&) noexcept;
+    Widget &operator=(Widget &&) noexcept;
 
     void setName(const std::string &name);
     void printData() const;
 
 private:
-    struct Impl;                // Forward declaration
-    std::unique_ptr<Impl> impl; // PIMPL pointer
+    struct Impl; // Forward declaration
+    // Impl is stored inline (no allocation for the Impl itself); only the
+    // buffer it manages is on the heap. Size/alignment for 64-bit targets.
+    FastPimpl<Impl, 40, 8> impl;
 };
 
 // ===== Widget.cpp (implementation) =====
 #include <cstring>
 #include <iostream>
+#include <utility>
 
 // Full definition hidden from users of the interface.
 struct Widget::Impl
@@ -41,21 +46,43 @@ struct Widget::Impl
         buffer[0] = '\0';
     }
 
+    // Impl now lives inside Widget, so moving a Widget moves the Impl: the
+    // buffer changes owner and the moved-from Impl is left without one.
+    Impl(Impl &&other) noexcept : name(std::move(other.name)), buffer(other.buffer)
+    {
+        other.buffer = nullptr;
+    }
+
+    Impl &operator=(Impl &&other) noexcept
+    {
+        std::swap(name, other.name);
+        std::swap(buffer, other.buffer);
+        return *this;
+    }
+
     ~Impl()
     {
-        std::cout << "[Impl] Deleting buffer at " << static_cast<void *>(buffer) << std::endl;
-        delete[] buffer;
+        if (buffer != nullptr)
+        {
+            std::cout << "[Impl] Deleting buffer at " << static_cast<void *>(buffer) << std::endl;
+            delete[] buffer;
+        }
     }
 };
 
-Widget::Widget() : impl(std::make_unique<Impl>())
-{
-}
+Widget::Widget() = default;
 
 Widget::~Widget() = default;
 
+Widget::Widget(Widget &&) noexcept = default;
+Widget &Widget::operator=(Widget &&) noexcept = default;
+
 void Widget::setName(const std::string &name)
 {
+    if (impl->buffer == nullptr)
+    {
+        impl->buffer = new char[100]; // moved-from widget gets a new buffer
+    }
     impl->name = name;
     std::strncpy(impl->buffer, name.c_str(), 99);
     impl->buffer[99] = '\0'; // Ensure null termination.
@@ -63,6 +90,11 @@ void Widget::setName(const std::string &name)
 
 void Widget::printData() const
 {
+    if (impl->buffer == nullptr)
+    {
+        std::cout << "Widget is empty (moved-from)." << std::endl;
+        return;
+    }
     std::cout << "Widget name: " << impl->name << ", buffer: " << impl->buffer << std::endl;
 }
 
@@ -73,7 +105,11 @@ int main()
         Widget w;
         w.setName("PIMPL+RAII Example");
         w.printData();
-    } // Widget and Impl destructors run here; cleanup log is printed.
+
+        Widget moved(std::move(w)); // the buffer moves with the inline Impl
+        moved.printData();
+        w.printData();
+    } // Widget and Impl destructors run here; cleanup log is printed once.
 
     return 0;
 }
@@ -3,9 +3,10 @@
 // Note: In a real project, these sections are separate physical files.
 
 // ===== widget.h (interface) =====
-#include <memory>
 #include <string>
 
+#include "FastPimpl.h"
+
 class Widget
 {
 public:
@@ -24,7 +25,9 @@ public:
 
 private:
     struct Impl;
-    std::unique_ptr<Impl> impl;
+    // Inline Impl storage (see FastPimpl.h); size/alignment for 64-bit targets.
+    // With no null pointer to test, "moved-from" is an Impl without a buffer.
+    FastPimpl<Impl, 40, 8> impl;
 };
 
 // ===== widget.cpp (implementation) =====
@@ -43,81 +46,86 @@ struct Widget::Impl
         std::cout << "[Impl] Default ctor, allocated buffer at " << static_cast<void *>(buffer) << std::endl;
     }
 
-    Impl(const Impl &other) : name(other.name), buffer(new char[100])
+    // Copying a moved-from Impl gives another empty one
+    Impl(const Impl &other) : name(other.name), buffer(other.buffer ? new char[100] : nullptr)
     {
-        std::strncpy(buffer, other.buffer, 99);
-        buffer[99] = '\0';
-        std::cout << "[Impl] Copy ctor, allocated buffer at " << static_cast<void *>(buffer) << std::endl;
+        if (buffer != nullptr)
+        {
+            std::strncpy(buffer, other.buffer, 99);
+            buffer[99] = '\0';
+            std::cout << "[Impl] Copy ctor, allocated buffer at " << static_cast<void *>(buffer) << std::endl;
+        }
     }
 
     Impl &operator=(const Impl &other)
     {
-        if (this != &other)
+        if (this == &other)
         {
+            return *this;
+        }
+        if (buffer != nullptr && other.buffer != nullptr)
+        {
+            // Both hold a buffer: reuse ours
             name = other.name;
             std::strncpy(buffer, other.buffer, 99);
             buffer[99] = '\0';
         }
+        else
+        {
+            Impl copy(other);
+            *this = std::move(copy);
+        }
         return *this;
     }
 
-    ~Impl()
+    // Moves hand the buffer over; the source keeps no buffer (moved-from state)
+    Impl(Impl &&other) noexcept : name(std::move(other.name)), buffer(other.buffer)
     {
-        std::cout << "[Impl] Deleting buffer at " << static_cast<void *>(buffer) << std::endl;
-        delete[] buffer;
+        other.buffer = nullptr;
     }
-};
-
-Widget::Widget() : impl(std::make_unique<Impl>())
-{
-}
-
-Widget::~Widget() = default;
-
-Widget::Widget(const Widget &other)
-    : impl(other.impl ? std::make_unique<Impl>(*other.impl) : nullptr)
-{
-}
 
-Widget &Widget::operator=(const Widget &other)
-{
-    if (this != &other)
+    Impl &operator=(Impl &&other) noexcept
     {
-        if (!other.impl)
-        {
-            impl.reset();
-        }
-        else if (!impl)
+        if (this != &other)
         {
-            impl = std::make_unique<Impl>(*other.impl);
+            name = std::move(other.name);
+            std::swap(buffer, other.buffer);
+            // Our old buffer (now in other) is released with the moved-from side
+            if (other.buffer != nullptr)
+            {
+                std::cout << "[Impl] Deleting buffer at " << static_cast<void *>(other.buffer) << std::endl;
+                delete[] other.buffer;
+                other.buffer = nullptr;
+            }
         }
-        else
+        return *this;
+    }
+
+    ~Impl()
+    {
+        if (buffer != nullptr)
         {
-            *impl = *other.impl;
+            std::cout << "[Impl] Deleting buffer at " << static_cast<void *>(buffer) << std::endl;
+            delete[] buffer;
         }
     }
-    return *this;
-}
+};
 
-Widget::Widget(Widget &&other) noexcept
-    : impl(std::move(other.impl))
-{
-}
+Widget::Widget() = default;
 
-Widget &Widget::operator=(Widget &&other) noexcept
-{
-    if (this != &other)
-    {
-        impl = std::move(other.impl);
-    }
-    return *this;
-}
+Widget::~Widget() = default;
+
+// The Impl's own copy/move operations do the work; FastPimpl forwards to them
+Widget::Widget(const Widget &other) = default;
+Widget &Widget::operator=(const Widget &other) = default;
+Widget::Widget(Widget &&other) noexcept = default;
+Widget &Widget::operator=(Widget &&other) noexcept = default;
 
 void Widget::setName(const std::string &name)
 {
-    if (!impl)
+    if (impl->buffer == nullptr)
     {
-        impl = std::make_unique<Impl>();
+        impl->buffer = new char[100];
     }
 
     impl->name = name;
@@ -127,7 +135,7 @@ void Widget::setName(const std::string &name)
 
 void Widget::printData() const
 {
-    if (!impl)
+    if (impl->buffer == nullptr)
     {
         std::cout << "Widget is empty (moved-from)." << std::endl;
         return;
@@ -141,7 +149,7 @@ void Widget::printData() const
 
 const void *Widget::bufferAddress() const
 {
-    return impl ? static_cast<void *>(impl->buffer) : nullptr;
+    return impl->buffer;
 }
 
 // ===== main.cpp (demo) =====
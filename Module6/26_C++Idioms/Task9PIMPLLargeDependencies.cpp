@@ -4,35 +4,55 @@
 
 // ===== bigdata.h (public interface) =====
 #include <cstddef>
-#include <memory>
 
+#include "FastPimpl.h"
+
+// Constructing a BigData is cheap: the heavy state (a million-element vector
+// and a map) is only built the first time something uses it. Copies share
+// that state and only take a private copy when one of them modifies it
+// (copy-on-write).
 class BigData
 {
 public:
     BigData();
     ~BigData();
 
-    void process();
-    std::size_t getSize() const;
+    BigData(const BigData &other);            // shares the data, if already loaded
+    BigData &operator=(const BigData &other);
+    BigData(BigData &&other) noexcept;
+    BigData &operator=(BigData &&other) noexcept;
+
+    void process();               // modifies: materializes and detaches if shared
+    std::size_t getSize() const;  // reads: materializes, never copies
+
+    bool isLoaded() const;
+    bool sharesDataWith(const BigData &other) const;
 
 private:
-    struct Impl;                // Forward declaration only.
-    std::unique_ptr<Impl> impl; // No heavy includes in the interface.
+    struct Impl; // Forward declaration only.
+    // Inline storage: no heavy includes in the interface and no allocation
+    // for the Impl object itself. Size/alignment for 64-bit targets.
+    FastPimpl<Impl, 24, 8> impl;
 };
 
 // ===== bigdata.cpp (implementation with heavy includes) =====
+#include <atomic>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
-struct BigData::Impl
+// The expensive part, built on first use and shared between copies
+struct HeavyState
 {
     std::vector<int> bigVector;
     std::map<std::string, int> bigMap;
     std::string name;
 
-    Impl()
+    HeavyState()
     {
         bigVector.resize(1'000'000, 42);
         name = "BigData resource";
@@ -40,36 +60,209 @@ struct BigData::Impl
         std::cout << "[BigData::Impl] constructed with heavy data" << std::endl;
     }
 
-    ~Impl()
+    HeavyState(const HeavyState &other)
+        : bigVector(other.bigVector), bigMap(other.bigMap), name(other.name)
+    {
+        std::cout << "[BigData::Impl] copied heavy data (copy-on-write detach)" << std::endl;
+    }
+
+    ~HeavyState()
     {
         std::cout << "[BigData::Impl] destroyed" << std::endl;
     }
 };
 
-BigData::BigData() : impl(std::make_unique<Impl>())
+// Lazy, thread-safe materialization with an atomic state:
+//   Empty -> Building (one thread wins the CAS and builds) -> Ready
+// Readers that find Ready use the data with a single acquire load; readers
+// that find Building wait for the builder. If the build throws, the state
+// returns to Empty and the next caller tries again.
+struct BigData::Impl
 {
-}
+    enum State
+    {
+        Empty,
+        Building,
+        Ready
+    };
+
+    mutable std::atomic<int> state{Empty};
+    mutable std::shared_ptr<HeavyState> heavy; // written once per load, before Ready
+
+    Impl() = default;
+
+    // A copy of a loaded object shares its state; a copy of an unloaded one
+    // stays unloaded and builds identical default data if it is ever used
+    Impl(const Impl &other)
+    {
+        if (other.state.load(std::memory_order_acquire) == Ready)
+        {
+            heavy = other.heavy;
+            state.store(Ready, std::memory_order_relaxed);
+        }
+    }
+
+    Impl &operator=(const Impl &other)
+    {
+        if (this != &other)
+        {
+            Impl copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    // Moves leave the source unloaded (it would lazily rebuild if used again)
+    Impl(Impl &&other) noexcept
+    {
+        if (other.state.load(std::memory_order_acquire) == Ready)
+        {
+            heavy = std::move(other.heavy);
+            state.store(Ready, std::memory_order_relaxed);
+            other.state.store(Empty, std::memory_order_relaxed);
+        }
+    }
+
+    Impl &operator=(Impl &&other) noexcept
+    {
+        if (this != &other)
+        {
+            bool loaded = other.state.load(std::memory_order_acquire) == Ready;
+            heavy = loaded ? std::move(other.heavy) : nullptr;
+            state.store(loaded ? Ready : Empty, std::memory_order_relaxed);
+            other.heavy = nullptr;
+            other.state.store(Empty, std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    const HeavyState &data() const
+    {
+        if (state.load(std::memory_order_acquire) != Ready)
+        {
+            materialize();
+        }
+        return *heavy;
+    }
+
+    void materialize() const
+    {
+        while (true)
+        {
+            int expected = Empty;
+            if (state.compare_exchange_strong(expected, Building, std::memory_order_acquire))
+            {
+                try
+                {
+                    heavy = std::make_shared<HeavyState>();
+                }
+                catch (...)
+                {
+                    state.store(Empty, std::memory_order_release);
+                    throw;
+                }
+                state.store(Ready, std::memory_order_release);
+                return;
+            }
+            if (expected == Ready)
+            {
+                return;
+            }
+            std::this_thread::yield(); // another thread is building
+        }
+    }
+
+    // Writers get a private copy first if the state is shared (copy-on-write).
+    // Like any non-const member, this must not race with other uses of the
+    // same BigData; other BigData objects sharing the state are unaffected.
+    HeavyState &mutableData()
+    {
+        data();
+        if (heavy.use_count() > 1)
+        {
+            heavy = std::make_shared<HeavyState>(*heavy);
+        }
+        return *heavy;
+    }
+};
+
+BigData::BigData() = default; // nothing heavy happens here
 
 BigData::~BigData() = default;
 
+BigData::BigData(const BigData &other) = default;
+BigData &BigData::operator=(const BigData &other) = default;
+BigData::BigData(BigData &&other) noexcept = default;
+BigData &BigData::operator=(BigData &&other) noexcept = default;
+
 void BigData::process()
 {
-    ++impl->bigVector[0];
-    impl->bigMap["process"] = impl->bigVector[0];
-    std::cout << "Processing " << impl->name << ": " << impl->bigVector[0] << std::endl;
+    HeavyState &data = impl->mutableData();
+    ++data.bigVector[0];
+    data.bigMap["process"] = data.bigVector[0];
+    std::cout << "Processing " << data.name << ": " << data.bigVector[0] << std::endl;
 }
 
 std::size_t BigData::getSize() const
 {
-    return impl->bigVector.size();
+    return impl->data().bigVector.size();
+}
+
+bool BigData::isLoaded() const
+{
+    return impl->state.load(std::memory_order_acquire) == Impl::Ready;
+}
+
+bool BigData::sharesDataWith(const BigData &other) const
+{
+    return isLoaded() && other.isLoaded() && impl->heavy == other.impl->heavy;
 }
 
 // ===== main.cpp (user code) =====
 // In a real multi-file project, main.cpp would include only bigdata.h and iostream.
+#include <chrono>
+
 int main()
 {
     BigData bd;
     bd.process();
     std::cout << "BigData size: " << bd.getSize() << std::endl;
+
+    // Most objects are never used, so they never pay for the heavy data
+    std::cout << "--- lazy construction ---" << std::endl;
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<BigData> many(10000);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Constructed " << many.size() << " BigData objects in " << ms << " ms, first loaded? "
+                  << (many[0].isLoaded() ? "yes" : "no") << std::endl;
+    }
+
+    // Four threads call a const member on a fresh object: it is built once
+    std::cout << "--- concurrent first use ---" << std::endl;
+    {
+        BigData shared;
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.emplace_back([&shared]()
+                                 { (void)shared.getSize(); });
+        }
+        for (auto &reader : readers)
+        {
+            reader.join();
+        }
+        std::cout << "Loaded once by 4 threads, size " << shared.getSize() << std::endl;
+    }
+
+    // Copies share until one of them writes
+    std::cout << "--- copy-on-write ---" << std::endl;
+    BigData copy = bd;
+    std::cout << "Copy shares data? " << (copy.sharesDataWith(bd) ? "yes" : "no") << std::endl;
+    std::cout << "Copy size (read, no detach): " << copy.getSize() << std::endl;
+    copy.process();
+    std::cout << "After write, copy shares data? " << (copy.sharesDataWith(bd) ? "yes" : "no") << std::endl;
+    bd.process(); // bd's data is unaffected by the copy's write
+
     return 0;
 }
@@ -0,0 +1,578 @@
+// WorkStealingPool.h - Work-stealing thread pool shared by the modules
+//
+// Each worker owns a Chase-Lev deque. A worker pushes and pops tasks at the
+// bottom of its own deque (LIFO, cache friendly), and idle workers steal from
+// the top of other workers' deques (FIFO, oldest = usually largest work).
+// Tasks submitted from outside the pool go to a shared injection queue.
+//
+//   WorkStealingPool pool;                       // hardware_concurrency workers
+//   std::future<int> f = pool.submit([] { return 6 * 7; });
+//   pool.parallelFor(0, n, [&](size_t i) { out[i] = f(in[i]); });
+//   long sum = pool.parallelReduce(0, n, 0L, [&](size_t i) { return v[i]; },
+//                                  [](long a, long b) { return a + b; });
+//
+// Nested parallelism: tasks may call parallelFor/parallelReduce or use a
+// TaskGroup. Waiting never blocks a worker; it runs other pending tasks until
+// the awaited work is done. Inside a task, wait on a future with
+// pool.await(future) for the same reason (future.get() would block the worker).
+//
+// Exceptions thrown by tasks reach the caller: through the future for
+// submit(), and rethrown from wait()/parallelFor/parallelReduce otherwise.
+//
+// Destruction (or shutdown()) lets queued tasks finish, then joins the workers.
+// Once shutdown() has begun, post()/submit() from outside the pool throw
+// std::runtime_error instead of queueing work no worker would run; tasks
+// already running may still spawn, since their worker drains them first.
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ----- Tasks -----
+
+struct PoolTask
+{
+    virtual ~PoolTask() {}
+    virtual void run() = 0;
+};
+
+template <typename F>
+struct PoolTaskImpl : PoolTask
+{
+    F fn;
+    explicit PoolTaskImpl(F f) : fn(std::move(f)) {}
+    void run() override { fn(); }
+};
+
+// ----- Chase-Lev deque -----
+//
+// Single owner (push/take at the bottom), any number of thieves (steal at the
+// top). Follows "Correct and Efficient Work-Stealing for Weak Memory Models"
+// (Le, Pop, Cohen, Zappa Nardelli, 2013). Grown arrays are kept until the
+// deque is destroyed, because a thief may still be reading an old one.
+class ChaseLevDeque
+{
+    struct Array
+    {
+        int64_t capacity;
+        int64_t mask;
+        std::unique_ptr<std::atomic<PoolTask *>[]> slots;
+
+        explicit Array(int64_t n) : capacity(n), mask(n - 1), slots(new std::atomic<PoolTask *>[n]) {}
+        PoolTask *get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, PoolTask *task) { slots[i & mask].store(task, std::memory_order_relaxed); }
+    };
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    alignas(64) std::atomic<Array *> array;
+    std::vector<std::unique_ptr<Array>> arrays; // owner-only
+
+public:
+    explicit ChaseLevDeque(int64_t capacity = 256)
+    {
+        arrays.emplace_back(new Array(capacity));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque &) = delete;
+    ChaseLevDeque &operator=(const ChaseLevDeque &) = delete;
+
+    // Owner only
+    void push(PoolTask *task)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Array *a = array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1)
+        {
+            Array *bigger = new Array(a->capacity * 2);
+            for (int64_t i = t; i < b; i++)
+                bigger->put(i, a->get(i));
+            arrays.emplace_back(bigger);
+            array.store(bigger, std::memory_order_release);
+            a = bigger;
+        }
+        a->put(b, task);
+        // A release store instead of the paper's release fence: same cost on
+        // x86/ARM64, and visible to ThreadSanitizer
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only; returns nullptr if empty
+    PoolTask *take()
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array *a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        PoolTask *task = a->get(b);
+        if (t == b)
+        {
+            // Last element: race against thieves for it
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                task = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    // Any thread; returns nullptr if empty or if another thread won the race
+    PoolTask *steal()
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+        Array *a = array.load(std::memory_order_acquire);
+        PoolTask *task = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return task;
+    }
+
+    bool looksEmpty() const
+    {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+};
+
+// ----- Pool -----
+
+class WorkStealingPool
+{
+    struct Worker
+    {
+        WorkStealingPool *pool;
+        size_t index;
+        ChaseLevDeque deque;
+        std::thread thread;
+
+        Worker(WorkStealingPool *p, size_t i) : pool(p), index(i) {}
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex injectionMutex;
+    std::deque<PoolTask *> injection;
+    std::atomic<size_t> injectionSize{0}; // lets findTask skip the mutex when empty
+
+    // Sleep/wake protocol: spawn() bumps queued and only takes the mutex when
+    // someone is (about to be) asleep; a sleeper re-checks queued under the
+    // mutex after announcing itself, so a wake-up cannot be lost.
+    std::atomic<long> queued{0};
+    std::atomic<int> sleepers{0};
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<bool> stopping{false};
+
+    static Worker *&currentWorker()
+    {
+        static thread_local Worker *worker = nullptr;
+        return worker;
+    }
+
+    Worker *localWorker() const
+    {
+        Worker *w = currentWorker();
+        return (w != nullptr && w->pool == this) ? w : nullptr;
+    }
+
+    static uint32_t nextRandom()
+    {
+        static thread_local uint32_t state = 0x9E3779B9u ^ (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id());
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    PoolTask *findTask(Worker *self)
+    {
+        if (self != nullptr)
+        {
+            if (PoolTask *task = self->deque.take())
+                return task;
+        }
+        if (injectionSize.load(std::memory_order_acquire) > 0)
+        {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            if (!injection.empty())
+            {
+                PoolTask *task = injection.front();
+                injection.pop_front();
+                injectionSize.store(injection.size(), std::memory_order_relaxed);
+                return task;
+            }
+        }
+        size_t n = workers.size();
+        size_t start = nextRandom() % n;
+        for (size_t k = 0; k < n; k++)
+        {
+            Worker *victim = workers[(start + k) % n].get();
+            if (victim == self)
+                continue;
+            if (PoolTask *task = victim->deque.steal())
+                return task;
+        }
+        return nullptr;
+    }
+
+    void execute(PoolTask *task)
+    {
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        std::unique_ptr<PoolTask> owned(task);
+        owned->run();
+    }
+
+    void workerLoop(Worker *self)
+    {
+        currentWorker() = self;
+        while (true)
+        {
+            if (PoolTask *task = findTask(self))
+            {
+                execute(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            while (queued.load(std::memory_order_seq_cst) == 0 && !stopping.load())
+                wakeUp.wait(lock);
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+            if (stopping.load() && queued.load() == 0)
+                break;
+        }
+        currentWorker() = nullptr;
+    }
+
+    // Takes ownership of task. The outside path checks stopping and counts
+    // the task under injectionMutex, which shutdown() also holds while setting
+    // stopping, so a worker never exits with an accepted task still queued.
+    void spawn(PoolTask *task)
+    {
+        if (Worker *self = localWorker())
+        {
+            self->deque.push(task);
+            queued.fetch_add(1, std::memory_order_seq_cst);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            if (stopping.load())
+            {
+                delete task;
+                throw std::runtime_error("WorkStealingPool: task submitted after shutdown()");
+            }
+            injection.push_back(task);
+            injectionSize.store(injection.size(), std::memory_order_release);
+            queued.fetch_add(1, std::memory_order_seq_cst);
+        }
+        if (sleepers.load(std::memory_order_seq_cst) > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+            }
+            wakeUp.notify_one();
+        }
+    }
+
+public:
+    explicit WorkStealingPool(size_t threads = std::thread::hardware_concurrency())
+    {
+        if (threads == 0)
+            threads = 1;
+        for (size_t i = 0; i < threads; i++)
+        {
+            workers.emplace_back(new Worker(this, i));
+        }
+        // Start only after every deque exists, since workers steal from all of them
+        for (auto &worker : workers)
+        {
+            Worker *w = worker.get();
+            w->thread = std::thread([this, w]()
+                                    { workerLoop(w); });
+        }
+    }
+
+    ~WorkStealingPool() { shutdown(); }
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    // Lets already queued tasks finish, then joins the workers. Safe to call
+    // twice. Later post()/submit() calls from other threads throw.
+    void shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> injectionLock(injectionMutex);
+            std::lock_guard<std::mutex> sleepLock(sleepMutex);
+            stopping.store(true);
+        }
+        wakeUp.notify_all();
+        for (auto &worker : workers)
+        {
+            if (worker->thread.joinable())
+                worker->thread.join();
+        }
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Runs one pending task on the calling thread; false if none was found
+    bool tryRunOne()
+    {
+        if (PoolTask *task = findTask(localWorker()))
+        {
+            execute(task);
+            return true;
+        }
+        return false;
+    }
+
+    // Keeps the calling thread busy with pool work while `busy()` is true
+    template <typename Predicate>
+    void helpWhile(Predicate busy)
+    {
+        while (busy())
+        {
+            if (!tryRunOne())
+                std::this_thread::yield();
+        }
+    }
+
+    // Fire-and-forget; the task must not throw (use submit or a TaskGroup)
+    template <typename F>
+    void post(F f)
+    {
+        spawn(new PoolTaskImpl<F>(std::move(f)));
+    }
+
+    template <typename F>
+    auto submit(F f) -> std::future<std::invoke_result_t<F>>
+    {
+        typedef std::invoke_result_t<F> Result;
+        std::packaged_task<Result()> task(std::move(f));
+        std::future<Result> result = task.get_future();
+        post(std::move(task));
+        return result;
+    }
+
+    // Like future.get(), but runs other tasks instead of blocking while waiting
+    template <typename T>
+    T await(std::future<T> &future)
+    {
+        helpWhile([&]()
+                  { return future.wait_for(std::chrono::seconds(0)) != std::future_status::ready; });
+        return future.get();
+    }
+
+    template <typename Index, typename F>
+    void parallelFor(Index begin, Index end, F body, size_t grain = 0);
+
+    template <typename Index, typename T, typename Map, typename Combine>
+    T parallelReduce(Index begin, Index end, T identity, Map map, Combine combine, size_t grain = 0);
+
+    // Default chunk size: about 8 chunks per worker, so stealing can even out
+    // uneven work without drowning in tiny tasks
+    size_t defaultGrain(size_t count) const
+    {
+        size_t chunks = workers.size() * 8;
+        return std::max<size_t>(1, count / chunks);
+    }
+};
+
+// ----- Fork/join helper -----
+
+// Tracks a set of spawned tasks. wait() helps run pool work until all of them
+// have finished, then rethrows the first exception any of them threw. After a
+// failure, tasks that have not started yet are skipped.
+class TaskGroup
+{
+    WorkStealingPool &pool;
+    std::atomic<long> pending{0};
+    std::atomic<bool> failed{false};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+public:
+    explicit TaskGroup(WorkStealingPool &p) : pool(p) {}
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+    ~TaskGroup()
+    {
+        // Never leave tasks pointing at a destroyed group
+        pool.helpWhile([this]()
+                       { return pending.load(std::memory_order_acquire) != 0; });
+    }
+
+    // Throws (and counts nothing) if the pool refuses the task after shutdown()
+    template <typename F>
+    void run(F f)
+    {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        try
+        {
+            post(std::move(f));
+        }
+        catch (...)
+        {
+            pending.fetch_sub(1, std::memory_order_release);
+            throw;
+        }
+    }
+
+private:
+    template <typename F>
+    void post(F f)
+    {
+        pool.post([this, f = std::move(f)]() mutable
+                  {
+            {
+                // Destroy the body's captures before the group can see it finish
+                F body(std::move(f));
+                if (!failed.load(std::memory_order_relaxed))
+                {
+                    try
+                    {
+                        body();
+                    }
+                    catch (...)
+                    {
+                        cancelWith(std::current_exception());
+                    }
+                }
+            }
+            pending.fetch_sub(1, std::memory_order_release); });
+    }
+
+public:
+    void cancelWith(std::exception_ptr e)
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+            error = e;
+        failed.store(true);
+    }
+
+    bool cancelled() const { return failed.load(std::memory_order_relaxed); }
+
+    void wait()
+    {
+        pool.helpWhile([this]()
+                       { return pending.load(std::memory_order_acquire) != 0; });
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (error)
+        {
+            std::exception_ptr e = error;
+            error = nullptr;
+            failed.store(false);
+            std::rethrow_exception(e);
+        }
+    }
+};
+
+// ----- Parallel algorithms -----
+//
+// Adaptive chunking: a range is split in half recursively; the right half is
+// spawned as a task and the left half is processed in place. Only when a
+// thief actually takes a half does it run elsewhere, so an idle pool splits
+// all the way down to `grain` while a busy pool keeps large chunks.
+
+template <typename Index, typename F>
+void WorkStealingPool::parallelFor(Index begin, Index end, F body, size_t grain)
+{
+    if (end <= begin)
+        return;
+    if (grain == 0)
+        grain = defaultGrain((size_t)(end - begin));
+
+    TaskGroup group(*this);
+    std::function<void(Index, Index)> split = [&](Index lo, Index hi)
+    {
+        while ((size_t)(hi - lo) > grain)
+        {
+            Index mid = lo + (hi - lo) / 2;
+            group.run([&split, mid, hi]()
+                      { split(mid, hi); });
+            hi = mid;
+        }
+        for (Index i = lo; i < hi && !group.cancelled(); ++i)
+            body(i);
+    };
+
+    try
+    {
+        split(begin, end);
+    }
+    catch (...)
+    {
+        group.cancelWith(std::current_exception());
+    }
+    group.wait();
+}
+
+template <typename Index, typename T, typename Map, typename Combine>
+T WorkStealingPool::parallelReduce(Index begin, Index end, T identity, Map map, Combine combine, size_t grain)
+{
+    if (end <= begin)
+        return identity;
+    if (grain == 0)
+        grain = defaultGrain((size_t)(end - begin));
+
+    // Each split combines left before right, so non-commutative (but
+    // associative) operations give the same result as a serial loop
+    std::function<T(Index, Index)> reduce = [&](Index lo, Index hi) -> T
+    {
+        if ((size_t)(hi - lo) <= grain)
+        {
+            T value = identity;
+            for (Index i = lo; i < hi; ++i)
+                value = combine(std::move(value), map(i));
+            return value;
+        }
+        Index mid = lo + (hi - lo) / 2;
+        T right = identity;
+        TaskGroup group(*this);
+        group.run([&]()
+                  { right = reduce(mid, hi); });
+        T left = identity;
+        try
+        {
+            left = reduce(lo, mid);
+        }
+        catch (...)
+        {
+            group.cancelWith(std::current_exception());
+        }
+        group.wait();
+        return combine(std::move(left), std::move(right));
+    };
+    return reduce(begin, end);
+}
+
+#endif // WORK_STEALING_POOL_H
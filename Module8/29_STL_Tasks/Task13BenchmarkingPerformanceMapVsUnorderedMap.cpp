@@ -1,12 +1,15 @@
 #include <chrono>
-#include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "../../Module4/18_IOStreams/TableFormatter.h"
+#include "../../Module6/26_C++Idioms/SamplingProfiler.h"
+
 // --- Configuration Constants ---
 constexpr int NUM_WORDS = 100000;
 constexpr int NUM_LOOKUP_TESTS = 10000;
@@ -16,18 +19,17 @@ constexpr int NUM_NONEXISTENT_WORDS = 10000;
 using WordVector = std::vector<std::string>;
 using MilliSeconds = std::chrono::duration<double, std::milli>;
 
-// Measure how long a callable takes to execute and print the elapsed time.
+// Measure how long a callable takes to execute and add the elapsed time to
+// the results table.
 template <typename Func>
-double measureTime(const std::string &description, Func func)
+double measureTime(const std::string &description, Func func, TableFormatter &results)
 {
     auto start = std::chrono::high_resolution_clock::now();
     func();
     auto end = std::chrono::high_resolution_clock::now();
 
     MilliSeconds duration = end - start;
-    std::cout << std::fixed << std::setprecision(3)
-              << "  " << std::left << std::setw(30) << description << ": "
-              << duration.count() << " ms\n";
+    results.cell(description).cell(duration.count()).cell("ms").endRow();
 
     return duration.count();
 }
@@ -69,12 +71,20 @@ void benchmarkContainer(const std::string &containerName,
 
     std::cout << "Insertion / lookup results:\n";
 
+    // Rows are collected while the benchmark runs and printed once at the
+    // end, so formatting never lands inside a timed section.
+    TableFormatter results;
+    results.addColumn("Measurement", TableFormatter::Left)
+        .addColumn("Value", TableFormatter::Right, 3)
+        .addColumn("Unit", TableFormatter::Left)
+        .setDecorations("  ", "  ", "");
+
     measureTime("Insertion", [&]()
                 {
         for (std::size_t i = 0; i < words_to_insert.size(); ++i)
         {
             my_container[words_to_insert[i]] = static_cast<int>(i);
-        } });
+        } }, results);
 
     volatile int found_count = 0;
     measureTime("Lookup (Existing Keys)", [&]()
@@ -86,7 +96,7 @@ void benchmarkContainer(const std::string &containerName,
             {
                 ++found_count;
             }
-        } });
+        } }, results);
 
     volatile int not_found_count = 0;
     measureTime("Lookup (Non-Existing Keys)", [&]()
@@ -98,21 +108,23 @@ void benchmarkContainer(const std::string &containerName,
             {
                 ++not_found_count;
             }
-        } });
+        } }, results);
 
-    std::cout << "  " << std::left << std::setw(30) << "Final Size"
-              << ": " << my_container.size() << "\n";
+    results.cell("Final Size").cell(my_container.size()).endRow();
 
     // Copy volatile counters to normal integers for clean output.
     const int found_total = found_count;
     const int not_found_total = not_found_count;
-    std::cout << "  " << std::left << std::setw(30) << "Existing lookups counted"
-              << ": " << found_total << "\n";
-    std::cout << "  " << std::left << std::setw(30) << "Missing lookups counted"
-              << ": " << not_found_total << "\n";
+    results.cell("Existing lookups counted").cell(found_total).endRow();
+    results.cell("Missing lookups counted").cell(not_found_total).endRow();
+
+    results.print(std::cout);
 }
 
-int main()
+// Usage: Task13BenchmarkingPerformanceMapVsUnorderedMap [--profile [file]]
+// --profile samples the benchmarks, prints the hottest functions and writes
+// collapsed stacks (default task13.folded) for a flame graph.
+int main(int argc, char *argv[])
 {
     std::cout << "==============================================\n";
     std::cout << "Benchmarking Performance: std::map vs std::unordered_map\n";
@@ -125,6 +137,17 @@ int main()
     WordVector non_existent_words = generateWords(NUM_NONEXISTENT_WORDS, "nonexistent_word_");
     std::cout << "Data generation complete.\n";
 
+    // Sampling stops and the report is printed when the session is destroyed
+    std::unique_ptr<SamplingProfilerSession> profile;
+    if (argc > 1 && std::string(argv[1]) == "--profile")
+    {
+        profile.reset(new SamplingProfilerSession(argc > 2 ? argv[2] : "task13.folded", &std::cout));
+        if (!profile->isActive())
+        {
+            std::cout << "Sampling profiler is not available on this platform.\n";
+        }
+    }
+
     benchmarkContainer<std::map<std::string, int>>("std::map<std::string, int>",
                                                    words_to_insert,
                                                    non_existent_words);
@@ -132,6 +155,11 @@ int main()
     benchmarkContainer<std::unordered_map<std::string, int>>("std::unordered_map<std::string, int>",
                                                              words_to_insert,
                                                              non_existent_words);
+    if (profile)
+    {
+        std::cout << "\n";
+        profile.reset();
+    }
 
     std::cout << "\nBenchmarking complete.\n";
     return 0;